@@ -48,6 +48,9 @@ void Keypad::readLine(const uint8_t row) {
         uint8_t pressed = !digitalRead(PIN_COLS[i]);
 
         if (pressed) {
+            if (mButtons[btn] == 0 && mKeyDownCallback) {
+                mKeyDownCallback(btn);
+            }
             // Increase counter, to measure duration of button press
             if (mButtons[btn] < 0xFF) {
                 mButtons[btn]++;
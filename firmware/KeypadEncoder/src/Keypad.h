@@ -21,11 +21,15 @@ static const uint8_t LONG_PRESS_DURATION = 50;
 
 using KeyPressCallback = void(*)(uint8_t btn, bool longPress);
 
+using KeyDownCallback = void(*)(uint8_t btn);
+
 class Keypad
 {
     private:
         // callback for key changes
         KeyPressCallback mKeyPressCallback = nullptr;
+        // callback for the press edge of a key, before the press is known to be short or long
+        KeyDownCallback mKeyDownCallback = nullptr;
 
         uint8_t mButtons[NUM_BUTTONS];
 
@@ -37,6 +41,8 @@ class Keypad
 
         void setPressEvent(KeyPressCallback callback) { mKeyPressCallback = callback; }
 
+        void setDownEvent(KeyDownCallback callback) { mKeyDownCallback = callback; }
+
         /**
          * Initialize all pins and routines.
          **/
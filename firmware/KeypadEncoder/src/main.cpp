@@ -30,6 +30,13 @@ bool StatusReceived = false;
 // Toggle projector power after receiving the status from the controller back
 bool ToggleProjectorPowerOnStatus = false;
 
+// After a long press, presses of the fire button tap the tempo until there was no tap for TAP_TIMEOUT_MS,
+// the same timeout the controller uses to end the tempo measurement.
+static bool TapMode = false;
+static unsigned long LastTap = 0;
+// The current press of the fire button has been sent as a tap
+static bool TapSent = false;
+
 static const uint8_t IRQ_COMMAND = 0;
 static const uint8_t IRQ_STATUS = 1;
 
@@ -149,6 +156,20 @@ void processKeypadCommand(uint8_t data)
     }
 }
 
+void onButtonDown(uint8_t btn)
+{
+    // Taps are sent on the press edge, so that the time between taps does not include how long the button is held
+    if (btn == 4 && TapMode) {
+        if (millis() - LastTap < TAP_TIMEOUT_MS) {
+            LastTap = millis();
+            TapSent = true;
+            sendCommand(CMD_TAP_TEMPO, 0, false);
+        } else {
+            TapMode = false;
+        }
+    }
+}
+
 void onButtonPress(uint8_t btn, bool longPress)
 {
     switch (btn) {
@@ -180,8 +201,14 @@ void onButtonPress(uint8_t btn, bool longPress)
                 sendHSVColor();
             }
             break;
-        case 4: // Fire mode
-            sendCommand(CMD_RGB_MODE, RGB_FIRE);
+        case 4: // Fire mode, long press to tap the tempo
+            if (longPress) {
+                TapMode = true;
+                LastTap = millis();
+            } else if (!TapSent) {
+                sendCommand(CMD_RGB_MODE, RGB_FIRE);
+            }
+            TapSent = false;
             break;
         case 5: // Movie mode
             sendCommand(CMD_PROJECTOR_MODE, PROJECTOR_NORMAL);
@@ -331,6 +358,7 @@ void setup() {
     Wire.onReceive(i2cReceive);
     Wire.onRequest(i2cRequest);
     keypad.setPressEvent(onButtonPress);
+    keypad.setDownEvent(onButtonDown);
 
     Serial.begin(UART_SPEED_CONTROLLER);
 
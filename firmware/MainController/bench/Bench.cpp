@@ -0,0 +1,157 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host benchmark helpers implementation.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <new>
+
+#include <NativeHost.h>
+
+#include "Settings.h"
+#include "MqttClient.h"
+#include "LED.h"
+
+// Same static storage as in the firmware, so members are zero-initialized the same way.
+static Settings settings;
+static MqttClient mqttClient(settings);
+static StripOutput stripOutput;
+static LEDDriver LEDs(settings, mqttClient, stripOutput);
+
+static std::atomic<uint64_t> allocationCount(0);
+
+static int failureCount = 0;
+
+void *operator new(size_t size)
+{
+    allocationCount++;
+    void *p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    allocationCount++;
+    void *p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t size) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t size) noexcept
+{
+    free(p);
+}
+
+uint64_t benchAllocationCount()
+{
+    return allocationCount.load();
+}
+
+LEDDriver &benchLEDs()
+{
+    static bool started = false;
+
+    if (!started) {
+        settings.begin();
+        LEDs.begin();
+        started = true;
+    }
+    return LEDs;
+}
+
+const uint8_t *benchWireData(size_t &length)
+{
+    static uint8_t wire[NUM_LEDS * 3];
+
+    // The shared driver adds the first controllers, one per segment
+    length = 0;
+    for (uint8_t i = 0; i < stripOutput.numSegments(); i++) {
+        size_t segmentLength;
+        const uint8_t *data = native::ledWireData(i, segmentLength);
+        if (length + segmentLength > sizeof(wire)) {
+            break;
+        }
+        memcpy(wire + length, data, segmentLength);
+        length += segmentLength;
+    }
+    return wire;
+}
+
+LEDDriver &benchOutputLEDs(LEDOutput &output)
+{
+    // Static storage, zero-initialized like the firmware driver
+    static LEDDriver outputLEDs(settings, mqttClient, output);
+    static bool started = false;
+
+    if (!started) {
+        benchLEDs();
+        outputLEDs.begin();
+        started = true;
+    }
+    return outputLEDs;
+}
+
+void BenchTimer::start()
+{
+    mStartAllocs = benchAllocationCount();
+    mStartNanos = native::wallNanos();
+}
+
+void BenchTimer::stop()
+{
+    mElapsedNanos += native::wallNanos() - mStartNanos;
+    mAllocs += benchAllocationCount() - mStartAllocs;
+}
+
+bool benchCheck(bool ok)
+{
+    failureCount += ok ? 0 : 1;
+    return ok;
+}
+
+int benchFailureCount()
+{
+    return failureCount;
+}
+
+void benchPrintHeader(const char *suite)
+{
+    printf("\n== %s ==\n", suite);
+    printf("%-24s %12s %12s  %s\n", "case", "ns/op", "allocs/op", "");
+}
+
+void benchPrintRow(const char *name, const BenchTimer &timer, int count, const char *extra)
+{
+    printf("%-24s %12.1f %12.2f  %s\n", name, timer.nanosPer(count), timer.allocsPer(count), extra);
+}
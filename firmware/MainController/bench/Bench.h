@@ -0,0 +1,115 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host benchmark helpers. Only built in the native environment.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+#include <stddef.h>
+
+class LEDDriver;
+class LEDOutput;
+
+struct BenchOptions
+{
+    // Number of measured frames per case
+    int frames = 2000;
+    // Number of frames rendered before measuring, to let fades settle
+    int warmupFrames = 200;
+};
+
+/**
+ * Measures wall time and heap allocations between start() and stop(), summed over all start/stop pairs.
+ */
+class BenchTimer
+{
+    private:
+        uint64_t mStartNanos = 0;
+        uint64_t mElapsedNanos = 0;
+        uint64_t mStartAllocs = 0;
+        uint64_t mAllocs = 0;
+
+    public:
+        void start();
+
+        void stop();
+
+        double nanosPer(int count) const { return count > 0 ? (double) mElapsedNanos / count : 0.0; }
+
+        double allocsPer(int count) const { return count > 0 ? (double) mAllocs / count : 0.0; }
+
+        uint64_t elapsedNanos() const { return mElapsedNanos; }
+};
+
+/**
+ * Number of calls to the global operator new since program start.
+ */
+uint64_t benchAllocationCount();
+
+/**
+ * LED driver shared by the suites, started on first use.
+ */
+LEDDriver &benchLEDs();
+
+/**
+ * Bytes last sent to the strip of the shared driver, joined over all data pins in strip order.
+ */
+const uint8_t *benchWireData(size_t &length);
+
+/**
+ * Second LED driver sending to the given output stage, started on first use. Later calls return the
+ * same driver, regardless of the output passed in.
+ */
+LEDDriver &benchOutputLEDs(LEDOutput &output);
+
+/**
+ * Record the outcome of a correctness check. The runner exits with an error if any check failed.
+ *
+ * @return ok
+ */
+bool benchCheck(bool ok);
+
+/**
+ * Number of failed checks since program start.
+ */
+int benchFailureCount();
+
+void benchPrintHeader(const char *suite);
+
+void benchPrintRow(const char *name, const BenchTimer &timer, int count, const char *extra = "");
+
+/* Benchmark suites */
+
+void benchEffects(const BenchOptions &options);
+
+void benchPalette(const BenchOptions &options);
+
+void benchRealtime(const BenchOptions &options);
+
+void benchDither(const BenchOptions &options);
+
+void benchBlend(const BenchOptions &options);
+
+void benchRamp(const BenchOptions &options);
+
+void benchLayout(const BenchOptions &options);
+
+void benchOutput(const BenchOptions &options);
+
+void benchGeometry(const BenchOptions &options);
+
+void benchCompose(const BenchOptions &options);
+
+void benchParticles(const BenchOptions &options);
+
+void benchNoise(const BenchOptions &options);
+
+void benchBeat(const BenchOptions &options);
+
+void benchAudio(const BenchOptions &options);
@@ -0,0 +1,222 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Audio spectrum: decay and peak hold of the levels, and the latency from a spectrum packet sent
+ * over loopback UDP until the frame showing it has been sent out.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <NativeHost.h>
+
+#include <commands.h>
+
+#include "LED.h"
+#include "AudioSpectrum.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+// Loud spectrum packets between silent ones, every this many frames
+static const int PULSE_FRAMES = 10;
+static const int PULSE_COUNT = 50;
+
+static void runFrames(LEDDriver &LEDs, int frames)
+{
+    for (int i = 0; i < frames; i++) {
+        native::advanceMillis(LED_FRAME_PERIOD_MS);
+        LEDs.loop();
+    }
+}
+
+static void checkDecay()
+{
+    AudioSpectrum spectrum;
+    uint8_t bands[AUDIO_NUM_BANDS];
+
+    memset(bands, 255, sizeof(bands));
+    spectrum.update(bands);
+
+    int silent = -1;
+    int peakFalls = -1;
+    int peakGone = -1;
+    for (int f = 1; f < 500 && peakGone < 0; f++) {
+        spectrum.advance(LED_FRAME_PERIOD_MS);
+
+        const AudioLevel &volume = spectrum.volume();
+        silent = silent < 0 && volume.value() == 0 ? f : silent;
+        peakFalls = peakFalls < 0 && volume.peak() < 255 ? f : peakFalls;
+        peakGone = peakGone < 0 && volume.peak() == 0 ? f : peakGone;
+    }
+
+    printf("%-24s level gone after %d ms, peak held %d ms, gone after %d ms\n", "decay",
+           silent * LED_FRAME_PERIOD_MS, (peakFalls - 1) * LED_FRAME_PERIOD_MS, peakGone * LED_FRAME_PERIOD_MS);
+}
+
+static void sendSpectrum(int sender, uint8_t level)
+{
+    // One sender for all checks, so that the sequence continues
+    static uint8_t sequence = 0;
+
+    uint8_t packet[5 + AUDIO_NUM_BANDS] = { 'F', 'L', 'S', 'P', sequence++ };
+    memset(packet + 5, level, AUDIO_NUM_BANDS);
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(AUDIO_SPECTRUM_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    sendto(sender, packet, sizeof(packet), 0, (struct sockaddr*) &addr, sizeof(addr));
+}
+
+/**
+ * Brightness of the frame sent out last, summed over all channels.
+ */
+static uint32_t frameSum()
+{
+    size_t length;
+    const uint8_t *data = benchWireData(length);
+
+    uint32_t sum = 0;
+    for (size_t i = 0; i < length; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+/**
+ * Send a loud spectrum every few frames and silence in between, like a sender analyzing a beat at
+ * the frame rate. The strip fades between the pulses, so a frame brighter than the previous one
+ * shows a pulse.
+ */
+static void checkLatency(LEDDriver &LEDs, RGBMode mode, int sender)
+{
+    LEDs.setRGBMode(mode, false);
+    runFrames(LEDs, 50);
+
+    uint32_t packets = LEDs.audioInput().packetCount();
+    uint32_t lost = LEDs.audioInput().lostCount();
+
+    uint32_t previous = frameSum();
+    int shown = 0;
+    double total = 0;
+    double worst = 0;
+
+    for (int f = 0; f < PULSE_COUNT * PULSE_FRAMES; f++) {
+        bool pulse = f % PULSE_FRAMES == 0;
+
+        // Packets arrive while the render task waits for the next frame
+        native::advanceMillis(LED_FRAME_PERIOD_MS);
+
+        BenchTimer timer;
+        timer.start();
+        sendSpectrum(sender, pulse ? 255 : 0);
+        LEDs.loop();
+        timer.stop();
+
+        uint32_t sum = frameSum();
+        if (pulse && sum > previous) {
+            double micros = timer.elapsedNanos() / 1000.0;
+            shown++;
+            total += micros;
+            worst = micros > worst ? micros : worst;
+        }
+        previous = sum;
+    }
+
+    benchCheck(shown == PULSE_COUNT && LEDs.audioInput().lostCount() == lost);
+
+    char name[32];
+    snprintf(name, sizeof(name), "latency, %s", strRGBMode(mode));
+
+    printf("%-24s %d/%d pulses in the next frame, send to sent out %.1f us, worst %.1f us, %u packets, %u lost\n",
+           name, shown, PULSE_COUNT, shown ? total / shown : 0.0, worst,
+           LEDs.audioInput().packetCount() - packets, LEDs.audioInput().lostCount() - lost);
+}
+
+static void checkInvalid(int sender)
+{
+    uint8_t packet[5 + AUDIO_NUM_BANDS] = { 'W', 'L', 'E', 'D' };
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(AUDIO_SPECTRUM_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    sendto(sender, packet, sizeof(packet), 0, (struct sockaddr*) &addr, sizeof(addr));
+    sendto(sender, packet, 4, 0, (struct sockaddr*) &addr, sizeof(addr));
+}
+
+static void runSpectrum(const BenchOptions &options)
+{
+    static AudioSpectrum spectrum;
+    uint8_t bands[AUDIO_NUM_BANDS];
+
+    BenchTimer timer;
+    timer.start();
+    for (int f = 0; f < options.frames; f++) {
+        for (uint8_t i = 0; i < AUDIO_NUM_BANDS; i++) {
+            bands[i] = f * 7 + i * 16;
+        }
+        spectrum.advance(LED_FRAME_PERIOD_MS);
+        spectrum.update(bands);
+    }
+    timer.stop();
+
+    char extra[32];
+    snprintf(extra, sizeof(extra), "volume %u, peak %u", spectrum.volume().value(), spectrum.volume().peak());
+    benchPrintRow("update and decay", timer, options.frames, extra);
+}
+
+void benchAudio(const BenchOptions &options)
+{
+    LEDDriver &LEDs = benchLEDs();
+
+    // Audio input is started once the network is up
+    native::setWiFiConnected(true);
+
+    LEDs.enableLEDStrip(true, false);
+    LEDs.setHSV(0, 255, 255, false);
+    LEDs.setTransition(0, false);
+    LEDs.setRGBMode(RGB_VU, false);
+    runFrames(LEDs, options.warmupFrames);
+
+    benchPrintHeader("audio (ns per frame)");
+
+    checkDecay();
+
+    int sender = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sender < 0 || !LEDs.audioInput().isStarted()) {
+        benchCheck(false);
+        printf("%-24s could not set up the loopback sockets\n", "latency");
+    } else {
+        checkLatency(LEDs, RGB_VU, sender);
+        checkLatency(LEDs, RGB_BASS, sender);
+        checkLatency(LEDs, RGB_SPECTRUM, sender);
+
+        uint32_t invalid = LEDs.audioInput().invalidCount();
+        checkInvalid(sender);
+        runFrames(LEDs, 1);
+        invalid = LEDs.audioInput().invalidCount() - invalid;
+        benchCheck(invalid == 2);
+        printf("%-24s %u of 2 foreign packets rejected\n", "invalid", invalid);
+
+        close(sender);
+    }
+
+    runSpectrum(options);
+
+    LEDs.setRGBMode(RGB_ON, false);
+    runFrames(LEDs, 1);
+}
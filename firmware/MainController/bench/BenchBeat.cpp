@@ -0,0 +1,246 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Beat clock: drift and continuity of the phase across tempo changes, and the tempo and beat
+ * taken over from taps and from beat clock packets sent over loopback UDP.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <NativeHost.h>
+
+#include <commands.h>
+
+#include "LED.h"
+#include "BeatClock.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+// Seconds of beats for the drift check
+static const uint32_t DRIFT_SECONDS = 600;
+
+/**
+ * Phase step of a frame against the nominal step at the tempo.
+ */
+static double stepRatio(uint32_t step, uint16_t bpm)
+{
+    return (double) step / BeatClock::beatsIn(LED_FRAME_PERIOD_MS, bpm);
+}
+
+/**
+ * Distance between two beat positions, the shorter way around, in 1/65536 beats.
+ */
+static int beatDistance(uint16_t a, uint16_t b)
+{
+    int16_t d = a - b;
+    return d < 0 ? -d : d;
+}
+
+static void checkDrift()
+{
+    BeatClock clock;
+    clock.setBPM(120 << 8);
+
+    for (uint32_t t = 0; t < DRIFT_SECONDS * 1000; t += LED_FRAME_PERIOD_MS) {
+        clock.advance(LED_FRAME_PERIOD_MS);
+    }
+
+    int32_t error = clock.phase() - (DRIFT_SECONDS * 2 << 16);
+    printf("%-24s %u beats after %u s at 120 BPM, error %d/65536 beats\n", "drift",
+           clock.phase() >> 16, DRIFT_SECONDS, error);
+}
+
+static void checkTempoChange()
+{
+    BeatClock clock;
+    clock.setBPM(60 << 8);
+
+    double maxRatio = 0;
+    uint32_t previous = clock.phase();
+
+    for (int f = 0; f < 200; f++) {
+        if (f == 100) {
+            clock.setBPM(150 << 8);
+        }
+        clock.advance(LED_FRAME_PERIOD_MS);
+
+        double ratio = stepRatio(clock.phase() - previous, clock.bpm());
+        maxRatio = ratio > maxRatio ? ratio : maxRatio;
+        previous = clock.phase();
+    }
+
+    printf("%-24s 60 to 150 BPM, largest step %.2f of the new tempo\n", "tempo change", maxRatio);
+}
+
+static void checkSync()
+{
+    BeatClock clock;
+    clock.setBPM(120 << 8);
+    clock.advance(1000);
+
+    // External beat is half a beat off
+    BeatClock external = clock;
+    external.advance(60000 / 120 / 2);
+    clock.sync(external.beat16());
+
+    double minRatio = 2;
+    double maxRatio = 0;
+    int frames = -1;
+    for (int f = 0; f < 500 && frames < 0; f++) {
+        uint32_t previous = clock.phase();
+
+        clock.advance(LED_FRAME_PERIOD_MS);
+        external.advance(LED_FRAME_PERIOD_MS);
+
+        double ratio = stepRatio(clock.phase() - previous, clock.bpm());
+        minRatio = ratio < minRatio ? ratio : minRatio;
+        maxRatio = ratio > maxRatio ? ratio : maxRatio;
+        if (beatDistance(clock.beat16(), external.beat16()) <= 1) {
+            frames = f + 1;
+        }
+    }
+
+    printf("%-24s half a beat caught up in %d ms, steps %.2f to %.2f of the tempo\n", "sync",
+           frames * LED_FRAME_PERIOD_MS, minRatio, maxRatio);
+}
+
+static void runFrames(LEDDriver &LEDs, int frames)
+{
+    for (int i = 0; i < frames; i++) {
+        native::advanceMillis(LED_FRAME_PERIOD_MS);
+        LEDs.loop();
+    }
+}
+
+/**
+ * Four taps at the given tempo, the beat must fall onto the last tap.
+ */
+static void checkTaps(LEDDriver &LEDs, uint8_t bpm)
+{
+    uint32_t interval = 60000 / bpm;
+
+    for (int i = 0; i < 4; i++) {
+        if (i > 0) {
+            runFrames(LEDs, interval / LED_FRAME_PERIOD_MS);
+        }
+        LEDs.tapTempo();
+    }
+    // Give the beat time to catch up with the last tap, over whole beats
+    uint32_t beats = (2000 + interval - 1) / interval;
+    runFrames(LEDs, beats * interval / LED_FRAME_PERIOD_MS);
+
+    int distance = beatDistance(LEDs.beatClock().beat16(), 0);
+
+    char name[32];
+    snprintf(name, sizeof(name), "taps at %u BPM", bpm);
+    printf("%-24s %.2f BPM, beat %.1f%% off the taps\n", name, LEDs.bpm() / 256.0, distance * 100.0 / 65536);
+
+    LEDs.setBPM(LED_DEFAULT_BPM << 8, false);
+    // Start the next measurement afresh
+    runFrames(LEDs, TAP_TIMEOUT_MS / LED_FRAME_PERIOD_MS + 1);
+}
+
+static void sendBeat(int sender, uint16_t bpm, uint16_t position)
+{
+    uint8_t packet[8] = { 'F', 'L', 'B', 'T', (uint8_t) (bpm >> 8), (uint8_t) bpm, (uint8_t) (position >> 8), (uint8_t) position };
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(BEAT_CLOCK_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    sendto(sender, packet, sizeof(packet), 0, (struct sockaddr*) &addr, sizeof(addr));
+}
+
+static void checkBeatInput(LEDDriver &LEDs)
+{
+    int sender = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sender < 0 || !LEDs.beatInput().isStarted()) {
+        benchCheck(false);
+        printf("%-24s could not set up the loopback sockets\n", "beat clock");
+        return;
+    }
+
+    // Sender runs at 100 BPM from its own beat position, one packet every 10 frames
+    BeatClock external;
+    external.setBPM(100 << 8);
+    external.advance(150);
+    uint32_t packets = LEDs.beatInput().packetCount();
+    int locked = -1;
+
+    for (int f = 0; f < 500; f++) {
+        // Packets carry the position at the time of the frame they are received in
+        external.advance(LED_FRAME_PERIOD_MS);
+        if (f % 10 == 0) {
+            sendBeat(sender, external.bpm(), external.beat16());
+        }
+        runFrames(LEDs, 1);
+
+        bool synced = beatDistance(LEDs.beatClock().beat16(), external.beat16()) <= 1;
+        locked = synced ? (locked < 0 ? f : locked) : -1;
+    }
+
+    benchCheck(locked >= 0 && LEDs.beatInput().invalidCount() == 0);
+
+    printf("%-24s %.2f BPM, locked after %d ms, %u packets, %u invalid\n", "beat clock",
+           LEDs.beatClock().bpm() / 256.0, locked * LED_FRAME_PERIOD_MS,
+           LEDs.beatInput().packetCount() - packets, LEDs.beatInput().invalidCount());
+
+    close(sender);
+}
+
+static void runAdvance(const BenchOptions &options)
+{
+    static BeatClock clock;
+    clock.setBPM(120 << 8);
+
+    BenchTimer timer;
+    timer.start();
+    for (int f = 0; f < options.frames; f++) {
+        clock.advance(LED_FRAME_PERIOD_MS);
+        if (f % 64 == 0) {
+            clock.sync(f << 8);
+        }
+    }
+    timer.stop();
+
+    char extra[32];
+    snprintf(extra, sizeof(extra), "phase %08x", clock.phase());
+    benchPrintRow("advance", timer, options.frames, extra);
+}
+
+void benchBeat(const BenchOptions &options)
+{
+    LEDDriver &LEDs = benchLEDs();
+
+    // Beat clock input is started once the network is up
+    native::setWiFiConnected(true);
+
+    LEDs.enableLEDStrip(true, false);
+    LEDs.setRGBMode(RGB_SCAN, false);
+    runFrames(LEDs, options.warmupFrames);
+
+    benchPrintHeader("beat (ns per frame)");
+
+    checkDrift();
+    checkTempoChange();
+    checkSync();
+    checkTaps(LEDs, 120);
+    // Slower than one tap per two seconds, down to the slowest tempo
+    checkTaps(LEDs, 10);
+    checkTaps(LEDs, LED_MIN_BPM);
+    checkBeatInput(LEDs);
+
+    runAdvance(options);
+}
@@ -0,0 +1,129 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Crossfade between effects: the packed blend kernel against blending pixel by pixel,
+ * and the cost of a frame while two effects are rendered.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <stdio.h>
+
+#include <NativeHost.h>
+
+#include <commands.h>
+
+#include "LED.h"
+#include "PixelBlend.h"
+
+static void runFrames(LEDDriver &LEDs, int frames)
+{
+    for (int i = 0; i < frames; i++) {
+        native::advanceMillis(LED_FRAME_PERIOD_MS);
+        LEDs.loop();
+    }
+}
+
+/**
+ * Count pixels which differ from the blend formula computed channel by channel.
+ */
+static int countMismatches(const CRGB *from, const CRGB *to, const CRGB *out, uint8_t amount)
+{
+    int mismatches = 0;
+
+    for (int i = 0; i < NUM_LEDS; i++) {
+        for (int c = 0; c < 3; c++) {
+            uint8_t exact = (from[i].raw[c] * (256 - amount) + to[i].raw[c] * amount) >> 8;
+            if (out[i].raw[c] != exact) {
+                mismatches++;
+                break;
+            }
+        }
+    }
+    return mismatches;
+}
+
+static void benchKernels(const BenchOptions &options)
+{
+    alignas(4) static CRGB from[NUM_LEDS];
+    alignas(4) static CRGB to[NUM_LEDS];
+    alignas(4) static CRGB out[NUM_LEDS];
+
+    fill_rainbow(from, NUM_LEDS, 0, 3);
+    fill_rainbow(to, NUM_LEDS, 128, 5);
+
+    int mismatches = 0;
+    for (int amount = 0; amount < 256; amount++) {
+        blendPixels(from, to, out, NUM_LEDS, amount);
+        mismatches += countMismatches(from, to, out, amount);
+    }
+
+    BenchTimer timer;
+    timer.start();
+    for (int i = 0; i < options.frames; i++) {
+        blendPixels(from, to, out, NUM_LEDS, i);
+    }
+    timer.stop();
+
+    benchCheck(mismatches == 0);
+
+    char extra[64];
+    snprintf(extra, sizeof(extra), "mismatches %d", mismatches);
+    benchPrintRow("blendPixels", timer, options.frames, extra);
+
+    timer = BenchTimer();
+    timer.start();
+    for (int i = 0; i < options.frames; i++) {
+        for (int p = 0; p < NUM_LEDS; p++) {
+            out[p] = blend(from[p], to[p], i);
+        }
+    }
+    timer.stop();
+    benchPrintRow("blend per pixel", timer, options.frames);
+}
+
+void benchBlend(const BenchOptions &options)
+{
+    LEDDriver &LEDs = benchLEDs();
+
+    LEDs.enableLEDStrip(true, false);
+    LEDs.setHSV(0, 255, 255, false);
+    LEDs.setRGBMode(RGB_CYCLE, false);
+    runFrames(LEDs, options.warmupFrames);
+
+    benchPrintHeader("blend (ns per frame)");
+
+    benchKernels(options);
+
+    // Frames spent crossfading between two animated effects, the transition covers all measured frames
+    uint32_t transition = LEDs.transition();
+    LEDs.setTransition((options.frames + 1) * LED_FRAME_PERIOD_MS, false);
+
+    static const RGBMode MODES[] = { RGB_RAINBOW, RGB_CYCLE };
+
+    for (RGBMode mode : MODES) {
+        runFrames(LEDs, options.warmupFrames);
+
+        uint32_t shows = native::ledShowCount();
+
+        BenchTimer timer;
+        LEDs.setRGBMode(mode, false);
+        timer.start();
+        runFrames(LEDs, options.frames);
+        timer.stop();
+
+        char extra[64];
+        snprintf(extra, sizeof(extra), "shows/frame %.2f",
+                 (double) (native::ledShowCount() - shows) / options.frames);
+
+        char name[32];
+        snprintf(name, sizeof(name), "crossfade to %s", strRGBMode(mode));
+        benchPrintRow(name, timer, options.frames, extra);
+    }
+
+    LEDs.setTransition(transition, false);
+}
@@ -0,0 +1,180 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Overlay compositor: cost of each layer type and blend mode, and a check that the effect
+ * below an overlay or a queue of notifications continues as if they had not been shown.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <NativeHost.h>
+
+#include <commands.h>
+
+#include "LED.h"
+#include "Compositor.h"
+
+// Frames of the effect after the overlays were started, they have all expired well before the end
+static const int CHECK_FRAMES = 150;
+static const uint32_t CHECK_LIFETIME_MS = 50 * LED_FRAME_PERIOD_MS;
+
+enum CheckOverlay {
+    CHECK_NONE,
+    CHECK_FLASH,
+    // Two notifications queued at once, shown one after the other
+    CHECK_NOTIFY
+};
+
+static void runFrames(LEDDriver &LEDs, int frames)
+{
+    for (int i = 0; i < frames; i++) {
+        native::advanceMillis(LED_FRAME_PERIOD_MS);
+        LEDs.loop();
+    }
+}
+
+static void runLayers(const char *name, const Overlay *overlays, uint8_t count, const BenchOptions &options)
+{
+    static Compositor compositor;
+    static CRGB frame[NUM_LEDS];
+
+    for (uint8_t i = 0; i < LED_NUM_LAYERS; i++) {
+        compositor.clear(i);
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        compositor.start(i, overlays[i]);
+    }
+    fill_rainbow(frame, NUM_LEDS, 0, 3);
+
+    BenchTimer timer;
+    timer.start();
+    for (int i = 0; i < options.frames; i++) {
+        compositor.advance(LED_FRAME_PERIOD_MS);
+        compositor.render(frame, LED_FRAME_PERIOD_MS);
+    }
+    timer.stop();
+    benchPrintRow(name, timer, options.frames);
+}
+
+/**
+ * Run the spin effect from a filled strip for the check frames and keep the wire data of every frame.
+ */
+static void runSpin(LEDDriver &LEDs, CheckOverlay overlay, uint8_t (*frames)[NUM_LEDS * 3])
+{
+    // The plain color resets the pixels the spin effect fades out
+    LEDs.setRGBMode(RGB_ON, false);
+    runFrames(LEDs, 5);
+
+    LEDs.setRGBMode(RGB_SPIN, false);
+    if (overlay == CHECK_FLASH) {
+        LEDs.showOverlay(Overlay{ OVERLAY_FLASH, BLEND_ADD, CRGB::White, 255, 1, CHECK_LIFETIME_MS });
+    }
+    if (overlay == CHECK_NOTIFY) {
+        LEDs.notify(NOTIFY_BLINK, CRGB::Red, 2);
+        LEDs.notify(NOTIFY_SWEEP, CRGB::Blue);
+    }
+
+    for (int i = 0; i < CHECK_FRAMES; i++) {
+        size_t length;
+        runFrames(LEDs, 1);
+        memcpy(frames[i], benchWireData(length), NUM_LEDS * 3);
+    }
+}
+
+/**
+ * Compare the frames with overlays against the effect alone: the overlays must only change the
+ * frames while they are shown, and the effect must continue unchanged afterwards.
+ */
+static void checkOverlay(LEDDriver &LEDs, const char *name, CheckOverlay overlay)
+{
+    static uint8_t reference[CHECK_FRAMES][NUM_LEDS * 3];
+    static uint8_t frames[CHECK_FRAMES][NUM_LEDS * 3];
+
+    runSpin(LEDs, CHECK_NONE, reference);
+    runSpin(LEDs, overlay, frames);
+
+    int first = -1;
+    int last = -1;
+    for (int i = 0; i < CHECK_FRAMES; i++) {
+        if (memcmp(reference[i], frames[i], sizeof(frames[i])) != 0) {
+            first = first < 0 ? i : first;
+            last = i;
+        }
+    }
+
+    benchCheck(first >= 0 && last < CHECK_FRAMES - 1);
+
+    if (first < 0) {
+        printf("%-24s NOT SHOWN\n", name);
+    } else {
+        // Frames are rendered at the end of each frame period
+        printf("%-24s shown from %u ms to %u ms, effect after the overlay: %s\n", name,
+               (first + 1) * LED_FRAME_PERIOD_MS, (last + 1) * LED_FRAME_PERIOD_MS,
+               last < CHECK_FRAMES - 1 ? "unchanged" : "CHANGED");
+    }
+}
+
+void benchCompose(const BenchOptions &options)
+{
+    LEDDriver &LEDs = benchLEDs();
+
+    LEDs.enableLEDStrip(true, false);
+    LEDs.setHSV(0, 255, 255, false);
+    LEDs.setTransition(0, false);
+    LEDs.setRGBMode(RGB_ON, false);
+    runFrames(LEDs, options.warmupFrames);
+
+    benchPrintHeader("compose (ns per frame)");
+
+    checkOverlay(LEDs, "flash on spin", CHECK_FLASH);
+    checkOverlay(LEDs, "blink 2x, then sweep", CHECK_NOTIFY);
+
+    // Long lifetimes, so that the layers stay for all measured frames
+    const uint32_t lifetime = (options.frames + 1) * LED_FRAME_PERIOD_MS;
+
+    const Overlay glitter  = { OVERLAY_GLITTER, BLEND_ADD, CRGB::White, 255, 80, 0 };
+    const Overlay flashAdd = { OVERLAY_FLASH, BLEND_ADD, CRGB::White, 255, 0, 0 };
+    const Overlay flashMax = { OVERLAY_FLASH, BLEND_MAX, CRGB::Red, 255, 0, 0 };
+    const Overlay flashAlpha = { OVERLAY_FLASH, BLEND_ALPHA, CRGB::Blue, 160, 0, 0 };
+    const Overlay progress = { OVERLAY_PROGRESS, BLEND_ALPHA, CRGB::Green, 200, 170, lifetime };
+
+    runLayers("glitter", &glitter, 1, options);
+    runLayers("flash add", &flashAdd, 1, options);
+    runLayers("flash max", &flashMax, 1, options);
+    runLayers("flash alpha", &flashAlpha, 1, options);
+    runLayers("progress alpha", &progress, 1, options);
+
+    const Overlay all[LED_NUM_LAYERS] = { glitter, flashAdd, progress, flashAlpha };
+    runLayers("all layers", all, LED_NUM_LAYERS, options);
+
+    // Frame loop of an animated effect, without and with overlays above it
+    LEDs.setRGBMode(RGB_SPIN, false);
+    runFrames(LEDs, options.warmupFrames);
+
+    for (int overlays = 0; overlays < 2; overlays++) {
+        uint8_t layers[2];
+        if (overlays) {
+            layers[0] = LEDs.showOverlay(Overlay{ OVERLAY_FLASH, BLEND_ADD, CRGB::White, 255, 0, lifetime });
+            layers[1] = LEDs.showOverlay(progress);
+        }
+
+        BenchTimer timer;
+        timer.start();
+        runFrames(LEDs, options.frames);
+        timer.stop();
+        benchPrintRow(overlays ? "spin with 2 overlays" : "spin", timer, options.frames);
+
+        if (overlays) {
+            LEDs.clearOverlay(layers[0]);
+            LEDs.clearOverlay(layers[1]);
+        }
+    }
+    runFrames(LEDs, 1);
+}
@@ -0,0 +1,180 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Cost of the high-precision output with temporal dithering, and how close the
+ * averaged output gets to the exact dimmed color.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <NativeHost.h>
+
+#include <commands.h>
+
+#include "LED.h"
+#include "TemporalDither.h"
+
+// Dim color where 8 bit brightness steps are visible
+static const uint8_t DIM_HUE = 32;
+static const uint8_t DIM_SATURATION = 160;
+static const uint8_t DIM_VALUE = 90;
+static const uint8_t DIM_INTENSITY = 40;
+
+static void runFrames(LEDDriver &LEDs, int frames)
+{
+    for (int i = 0; i < frames; i++) {
+        native::advanceMillis(LED_FRAME_PERIOD_MS);
+        LEDs.loop();
+    }
+}
+
+/**
+ * Mean difference between the wire output averaged over the given frames and the exact dimmed color, in 8 bit steps.
+ */
+static double averageError(LEDDriver &LEDs, int frames)
+{
+    static double sum[NUM_LEDS * 3];
+
+    for (int i = 0; i < NUM_LEDS * 3; i++) {
+        sum[i] = 0;
+    }
+    for (int f = 0; f < frames; f++) {
+        runFrames(LEDs, 1);
+
+        size_t length;
+        const uint8_t *wire = benchWireData(length);
+        for (size_t i = 0; i < length && i < NUM_LEDS * 3; i++) {
+            sum[i] += wire[i];
+        }
+    }
+
+    CRGB color;
+    hsv2rgb_rainbow(CHSV(DIM_HUE, DIM_SATURATION, 255), color);
+    CRGB correction(TypicalLEDStrip);
+
+    // Strip is wired in GRB order
+    const uint8_t order[3] = { 1, 0, 2 };
+    double error = 0;
+
+    for (int i = 0; i < NUM_LEDS; i++) {
+        for (int c = 0; c < 3; c++) {
+            uint8_t channel = order[c];
+            double exact = color.raw[channel] * (DIM_VALUE / 255.0) * (DIM_INTENSITY / 255.0) * ((correction.raw[channel] + 1) / 256.0);
+            error += fabs(sum[i * 3 + c] / frames - exact);
+        }
+    }
+    return error / (NUM_LEDS * 3);
+}
+
+/**
+ * Full white at full scale must be sent as 255 in every frame, without a residual which keeps a static
+ * frame from being skipped.
+ */
+static void checkFullScale(LEDDriver &LEDs)
+{
+    static TemporalDither dither;
+    static CRGB white[NUM_LEDS];
+    static CRGB output[NUM_LEDS];
+    const uint16_t full[3] = { 0xFFFF, 0xFFFF, 0xFFFF };
+
+    fill_solid(white, NUM_LEDS, CRGB::White);
+
+    bool residual = false;
+    int mismatches = 0;
+    for (int f = 0; f < 256; f++) {
+        residual |= dither.apply(white, output, NUM_LEDS, full);
+        for (int i = 0; i < NUM_LEDS; i++) {
+            mismatches += output[i] != CRGB(CRGB::White);
+        }
+    }
+    benchCheck(!residual && mismatches == 0);
+    printf("%-24s %s, %d pixels below 255\n", "full scale", residual ? "RESIDUAL" : "no residual", mismatches);
+
+    // Through the driver, the red channel has no color correction
+    LEDs.setHSV(0, 0, 255, false);
+    LEDs.setRGBMode(RGB_ON, false);
+    // Let the crossfade from the previous mode and the color ramp finish
+    runFrames(LEDs, (LED_TRANSITION_MS + LED_RAMP_MS) / LED_FRAME_PERIOD_MS);
+
+    int below = 0;
+    for (int f = 0; f < 256; f++) {
+        runFrames(LEDs, 1);
+
+        size_t length;
+        const uint8_t *wire = benchWireData(length);
+        for (size_t i = 1; i < length; i += 3) {
+            below += wire[i] != 255;
+        }
+    }
+    benchCheck(below == 0);
+    printf("%-24s %d red values below 255\n", "full white dithered", below);
+
+    LEDs.setHSV(DIM_HUE, DIM_SATURATION, DIM_VALUE, false);
+}
+
+void benchDither(const BenchOptions &options)
+{
+    LEDDriver &LEDs = benchLEDs();
+
+    LEDs.enableLEDStrip(true, false);
+    LEDs.setHSV(DIM_HUE, DIM_SATURATION, DIM_VALUE, false);
+    LEDs.setDimmedIntensity(DIM_INTENSITY, false);
+
+    benchPrintHeader("dither (ns per frame)");
+
+    // A static and an animated mode which both leave the color unchanged
+    static const RGBMode MODES[] = { RGB_DIMMED, RGB_FIRE };
+
+    for (int d = 0; d < 2; d++) {
+        LEDs.enableDither(d == 1);
+
+        for (RGBMode mode : MODES) {
+            LEDs.setRGBMode(mode, false);
+            runFrames(LEDs, options.warmupFrames);
+
+            uint32_t shows = native::ledShowCount();
+
+            BenchTimer timer;
+            timer.start();
+            runFrames(LEDs, options.frames);
+            timer.stop();
+
+            char extra[64];
+            int length = snprintf(extra, sizeof(extra), "shows/frame %.2f",
+                                  (double) (native::ledShowCount() - shows) / options.frames);
+            if (mode == RGB_DIMMED) {
+                snprintf(extra + length, sizeof(extra) - length, "  avg error %.3f", averageError(LEDs, 256));
+            }
+
+            char name[32];
+            snprintf(name, sizeof(name), "%s%s", strRGBMode(mode), d ? " dithered" : "");
+            benchPrintRow(name, timer, options.frames, extra);
+        }
+    }
+    LEDs.enableDither(true);
+    checkFullScale(LEDs);
+    LEDs.enableDither(false);
+
+    // Quantization stage alone
+    static TemporalDither dither;
+    static CRGB pixels[NUM_LEDS];
+    static CRGB output[NUM_LEDS];
+    const uint16_t scale[3] = { 3600, 2500, 3400 };
+
+    fill_rainbow(pixels, NUM_LEDS, 0, 1);
+
+    BenchTimer timer;
+    timer.start();
+    for (int i = 0; i < options.frames; i++) {
+        dither.apply(pixels, output, NUM_LEDS, scale);
+    }
+    timer.stop();
+    benchPrintRow("TemporalDither::apply", timer, options.frames);
+}
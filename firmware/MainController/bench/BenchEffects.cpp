@@ -0,0 +1,63 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Render cost of every RGB mode through the LEDDriver frame loop.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <stdio.h>
+
+#include <NativeHost.h>
+
+#include <commands.h>
+
+#include "LED.h"
+
+static const uint32_t FRAME_PERIOD_MS = 20;
+
+static void runFrames(LEDDriver &LEDs, int frames)
+{
+    for (int i = 0; i < frames; i++) {
+        native::advanceMillis(FRAME_PERIOD_MS);
+        LEDs.loop();
+    }
+}
+
+void benchEffects(const BenchOptions &options)
+{
+    LEDDriver &LEDs = benchLEDs();
+
+    LEDs.enableLEDStrip(true, false);
+    // Fully saturated, so every hue change shows up in the frame
+    LEDs.setHSV(0, 255, 255, false);
+
+    benchPrintHeader("effects (ns per frame)");
+
+    for (uint8_t i = 0; i < numEffects(); i++) {
+        RGBMode mode = effectAt(i).mode;
+
+        LEDs.setRGBMode(mode, false);
+        runFrames(LEDs, options.warmupFrames);
+
+        uint32_t shows = native::ledShowCount();
+
+        BenchTimer timer;
+        timer.start();
+        runFrames(LEDs, options.frames);
+        timer.stop();
+
+        // Share of the frame period spent rendering on the host
+        double budget = timer.nanosPer(options.frames) / (LED_FRAME_PERIOD_MS * 10000.0);
+
+        char extra[64];
+        snprintf(extra, sizeof(extra), "shows/frame %.2f  budget %.3f%%",
+                 (double) (native::ledShowCount() - shows) / options.frames, budget);
+
+        benchPrintRow(strRGBMode(mode), timer, options.frames, extra);
+    }
+}
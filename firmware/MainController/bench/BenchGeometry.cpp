@@ -0,0 +1,151 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Pixel coordinate map: the compile-time table against the positions computed at runtime,
+ * and the cost of sampling spatial functions against index-based ones.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "LEDGeometry.h"
+
+static const uint8_t WAVES = 3 << 4;
+
+/**
+ * Compare the table with atan2() and sqrt() on the same positions, in 8 bit steps.
+ */
+static void checkTable()
+{
+    double centerX = StripGeometry::WIDTH / 2;
+    double centerY = StripGeometry::HEIGHT / 2;
+    double maxDistance = sqrt(centerX * centerX + centerY * centerY);
+
+    int angleError = 0;
+    int distanceError = 0;
+    int asymmetric = 0;
+
+    for (int i = 0; i < NUM_LEDS; i++) {
+        const PixelCoord &coord = StripGeometry::at(i);
+        double dx = StripGeometry::rawX(i) - centerX;
+        double dy = StripGeometry::rawY(i) - centerY;
+
+        int angle = (int) lround(atan2(dy, dx) * 128 / M_PI) & 0xFF;
+        int distance = (int) lround(sqrt(dx * dx + dy * dy) * 255 / maxDistance);
+
+        int da = abs((int8_t) (coord.angle - angle));
+        int dd = abs(coord.distance - distance);
+        angleError = da > angleError ? da : angleError;
+        distanceError = dd > distanceError ? dd : distanceError;
+
+        // Both halves are the same distance from the center, on opposite sides of the x axis
+        const PixelCoord &mirrored = StripGeometry::at(StripLayout::mirrorIndex(i));
+        if (coord.distance != mirrored.distance || coord.x != mirrored.x || coord.y + mirrored.y != 255) {
+            asymmetric++;
+        }
+    }
+
+    benchCheck(asymmetric == 0);
+
+    printf("%-24s %u pixels, %u bytes, max error angle %d distance %d, asymmetric %d\n", "coordinate table",
+           NUM_LEDS, (unsigned) sizeof(StripGeometry::Coords::values), angleError, distanceError, asymmetric);
+}
+
+/* Kernels are not inlined, so that the frames are not folded into the last one */
+
+__attribute__((noinline)) static void indexWave(uint8_t *levels, uint8_t offset)
+{
+    for (int i = 0; i < NUM_LEDS; i++) {
+        levels[i] = sin8(i * 3 - offset);
+    }
+}
+
+__attribute__((noinline)) static void radialWave(uint8_t *levels, uint8_t offset)
+{
+    for (int i = 0; i < NUM_LEDS; i++) {
+        levels[i] = sin8(radialPhase(StripGeometry::at(i), WAVES, offset));
+    }
+}
+
+/**
+ * Same wave with the distance computed per pixel and frame.
+ */
+__attribute__((noinline)) static void radialWaveComputed(uint8_t *levels, uint8_t offset)
+{
+    const float centerX = StripGeometry::WIDTH / 2;
+    const float centerY = StripGeometry::HEIGHT / 2;
+    const float scale = 255 / sqrtf(centerX * centerX + centerY * centerY);
+
+    for (int i = 0; i < NUM_LEDS; i++) {
+        float dx = StripGeometry::rawX(i) - centerX;
+        float dy = StripGeometry::rawY(i) - centerY;
+        PixelCoord coord = { 0, 0, 0, (uint8_t) (sqrtf(dx * dx + dy * dy) * scale + 0.5f) };
+        levels[i] = sin8(radialPhase(coord, WAVES, offset));
+    }
+}
+
+__attribute__((noinline)) static void sweep(uint8_t *levels, uint8_t direction)
+{
+    SweepAxis axis(direction);
+    for (int i = 0; i < NUM_LEDS; i++) {
+        levels[i] = axis.position(StripGeometry::at(i));
+    }
+}
+
+typedef void (*Kernel)(uint8_t *levels, uint8_t offset);
+
+static void runKernel(const char *name, Kernel kernel, const BenchOptions &options, const char *extra = "")
+{
+    static uint8_t levels[NUM_LEDS];
+
+    BenchTimer timer;
+    timer.start();
+    for (int f = 0; f < options.frames; f++) {
+        kernel(levels, f);
+    }
+    timer.stop();
+    benchPrintRow(name, timer, options.frames, extra);
+}
+
+/**
+ * Largest difference between the sweep positions and the exact projection, over all directions.
+ */
+static int sweepError()
+{
+    static uint8_t levels[NUM_LEDS];
+    int maxError = 0;
+
+    for (int direction = 0; direction < 256; direction++) {
+        sweep(levels, direction);
+        for (int i = 0; i < NUM_LEDS; i++) {
+            const PixelCoord &coord = StripGeometry::at(i);
+            int expected = 128 + (int) lround(((coord.x - 128) * cos(direction * M_PI / 128) +
+                                               (coord.y - 128) * sin(direction * M_PI / 128)) * 127 / 181);
+            int error = abs(levels[i] - expected);
+            maxError = error > maxError ? error : maxError;
+        }
+    }
+    return maxError;
+}
+
+void benchGeometry(const BenchOptions &options)
+{
+    benchPrintHeader("geometry (ns per frame)");
+
+    checkTable();
+
+    runKernel("wave by index", indexWave, options);
+    runKernel("radial wave, table", radialWave, options);
+    runKernel("radial wave, computed", radialWaveComputed, options);
+
+    char extra[64];
+    snprintf(extra, sizeof(extra), "max error %d", sweepError());
+    runKernel("sweep, table", sweep, options, extra);
+}
@@ -0,0 +1,91 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Frame budget for the configured strip length: render time per frame and the time to
+ * send the frame over the data line. Build the native_300, native_600 and native_1200
+ * environments to compare longer strips.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <stdio.h>
+
+#include <NativeHost.h>
+
+#include <commands.h>
+
+#include "LED.h"
+
+// WS2815 timing: 24 bits of 1.25 us per pixel, followed by the latch
+static const double WIRE_MICROS_PER_PIXEL = 30.0;
+static const double WIRE_LATCH_MICROS = 280.0;
+
+static void runFrames(LEDDriver &LEDs, int frames)
+{
+    for (int i = 0; i < frames; i++) {
+        native::advanceMillis(LED_FRAME_PERIOD_MS);
+        LEDs.loop();
+    }
+}
+
+void benchLayout(const BenchOptions &options)
+{
+    LEDDriver &LEDs = benchLEDs();
+
+    LEDs.enableLEDStrip(true, false);
+    LEDs.setHSV(0, 255, 255, false);
+
+    double wireMicros = NUM_LEDS * WIRE_MICROS_PER_PIXEL + WIRE_LATCH_MICROS;
+
+    char header[96];
+    snprintf(header, sizeof(header), "layout %u pixels, side %u, center %u (ns per frame)",
+             NUM_LEDS, StripLayout::SIDE_LENGTH, StripLayout::CENTER_LENGTH);
+    benchPrintHeader(header);
+
+    printf("%-24s %.0f us, at most %.0f fps (frame period %u ms, shortest %u ms)\n", "wire time",
+           wireMicros, 1000000.0 / wireMicros, LED_FRAME_PERIOD_MS, LED_MIN_FRAME_PERIOD_MS);
+
+    // Period the dynamic effects run at with this wire time, capped for strips which take too long to send
+    uint32_t period = LEDDriver::adaptiveFramePeriod(wireMicros);
+    printf("%-24s %u ms, %.0f%% of it on the wire%s\n", "adaptive frame period", period,
+           wireMicros / (period * 10.0), period == LED_MAX_FRAME_PERIOD_MS ? ", capped" : "");
+
+    // Cheapest and most expensive effects, mirrored and full length
+    static const RGBMode MODES[] = { RGB_CYCLE, RGB_FIRE, RGB_RAINBOW, RGB_WATER };
+
+    for (int crossfade = 0; crossfade < 2; crossfade++) {
+        uint32_t transition = LEDs.transition();
+        LEDs.setTransition(crossfade ? (options.warmupFrames + options.frames + 1) * LED_FRAME_PERIOD_MS : 0, false);
+
+        for (RGBMode mode : MODES) {
+            if (crossfade) {
+                // Crossfade from the previous mode in the list
+                LEDs.setRGBMode(mode == RGB_CYCLE ? RGB_WATER : RGB_CYCLE, false);
+                runFrames(LEDs, 2);
+            }
+            LEDs.setRGBMode(mode, false);
+            runFrames(LEDs, options.warmupFrames);
+
+            BenchTimer timer;
+            timer.start();
+            runFrames(LEDs, options.frames);
+            timer.stop();
+
+            // Rendering on the host plus sending on the wire, against the animation frame period
+            double frameMicros = timer.nanosPer(options.frames) / 1000.0 + wireMicros;
+            double budget = frameMicros * 100.0 / (LED_FRAME_PERIOD_MS * 1000.0);
+
+            char extra[64];
+            snprintf(extra, sizeof(extra), "budget %.2f%%%s", budget, budget > 100.0 ? "  OVER" : "");
+
+            char name[32];
+            snprintf(name, sizeof(name), "%s%s", strRGBMode(mode), crossfade ? " crossfade" : "");
+            benchPrintRow(name, timer, options.frames, extra);
+        }
+        LEDs.setTransition(transition, false);
+    }
+}
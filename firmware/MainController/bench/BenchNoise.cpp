@@ -0,0 +1,130 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Noise field: cost per frame of the cached lattice against inoise8() per pixel, and the spread
+ * of the values both produce.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <FastLED.h>
+
+#include "config.h"
+#include "NoiseField.h"
+
+// Pixels per lattice cell and time steps per second, as used by the lava effect
+static const uint8_t CELL_PIXELS = 24;
+static const uint16_t SPEED = 40;
+
+/**
+ * Spread of the noise values over all frames.
+ */
+class NoiseStats
+{
+    private:
+        uint8_t  mMin = 255;
+        uint8_t  mMax = 0;
+        double   mSum = 0;
+        double   mSquares = 0;
+        uint32_t mCount = 0;
+
+    public:
+        void add(const uint8_t *levels, int length)
+        {
+            for (int i = 0; i < length; i++) {
+                mMin = levels[i] < mMin ? levels[i] : mMin;
+                mMax = levels[i] > mMax ? levels[i] : mMax;
+                mSum += levels[i];
+                mSquares += levels[i] * levels[i];
+            }
+            mCount += length;
+        }
+
+        void format(char *buffer, size_t size) const
+        {
+            double mean = mSum / mCount;
+            snprintf(buffer, size, "range %3u-%3u  mean %.0f  stddev %.1f", mMin, mMax, mean,
+                     sqrt(mSquares / mCount - mean * mean));
+        }
+};
+
+/**
+ * Reference: FastLED noise evaluated for every pixel and octave, with the same scales and weights.
+ */
+__attribute__((noinline)) static void inoiseFrame(uint8_t *levels, uint8_t octaves, uint32_t time)
+{
+    const uint16_t step = 256 / CELL_PIXELS;
+
+    for (int i = 0; i < NUM_LEDS; i++) {
+        if (octaves == 1) {
+            levels[i] = inoise8(i * step, time);
+            continue;
+        }
+        uint16_t sum = inoise8(i * step, time) * 146;
+        sum += inoise8(i * step * 2, (time << 1) + 0x4000) * 73;
+        sum += inoise8(i * step * 4, (time << 2) + 0x8000) * 37;
+        levels[i] = sum >> 8;
+    }
+}
+
+__attribute__((noinline)) static void fieldFrame(uint8_t *levels, NoiseField &field)
+{
+    field.advance(LED_FRAME_PERIOD_MS);
+    for (int i = 0; i < NUM_LEDS; i++) {
+        levels[i] = field.sample(i);
+    }
+}
+
+static void runInoise(const char *name, uint8_t octaves, const BenchOptions &options)
+{
+    static uint8_t levels[NUM_LEDS];
+    NoiseStats stats;
+    BenchTimer timer;
+
+    for (int f = 0; f < options.frames; f++) {
+        timer.start();
+        inoiseFrame(levels, octaves, f * SPEED * LED_FRAME_PERIOD_MS / 1000);
+        timer.stop();
+        stats.add(levels, NUM_LEDS);
+    }
+
+    char extra[96];
+    stats.format(extra, sizeof(extra));
+    benchPrintRow(name, timer, options.frames, extra);
+}
+
+static void runField(const BenchOptions &options)
+{
+    static NoiseField field;
+    static uint8_t levels[NUM_LEDS];
+    NoiseStats stats;
+    BenchTimer timer;
+
+    field.start(0, CELL_PIXELS, SPEED);
+    for (int f = 0; f < options.frames; f++) {
+        timer.start();
+        fieldFrame(levels, field);
+        timer.stop();
+        stats.add(levels, NUM_LEDS);
+    }
+
+    char extra[96];
+    stats.format(extra, sizeof(extra));
+    benchPrintRow("noise field, 3 octaves", timer, options.frames, extra);
+}
+
+void benchNoise(const BenchOptions &options)
+{
+    benchPrintHeader("noise (ns per frame)");
+
+    runInoise("inoise8, 1 octave", 1, options);
+    runInoise("inoise8, 3 octaves", 3, options);
+    runField(options);
+}
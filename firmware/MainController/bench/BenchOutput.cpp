@@ -0,0 +1,219 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Output stage: segment mapping of the FastLED outputs, and the wire time of each data
+ * pin with the strip on one pin or split into its mirrored halves.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <NativeHost.h>
+
+#include <commands.h>
+
+#include "LED.h"
+#include "LEDOutput.h"
+
+// WS2815 timing: 24 bits of 1.25 us per pixel, followed by the latch
+static const double WIRE_MICROS_PER_PIXEL = 30.0;
+static const double WIRE_LATCH_MICROS = 280.0;
+
+static const uint8_t MAX_OUTPUTS = 2;
+
+/**
+ * Output stage which keeps the pixels sent on each data pin and the time each pin would take.
+ */
+class MockOutput : public LEDOutput
+{
+    private:
+        OutputSegment mSegments[MAX_OUTPUTS];
+        uint8_t mNumSegments = 1;
+
+    public:
+        // Pixels sent on each pin with the last frame
+        CRGB   pixels[MAX_OUTPUTS][NUM_LEDS];
+        double wireMicros[MAX_OUTPUTS];
+        uint32_t shows = 0;
+
+        MockOutput() { split(1); }
+
+        /**
+         * Split the strip evenly over the given number of pins, like FastLEDOutput.
+         */
+        void split(uint8_t outputs)
+        {
+            mNumSegments = outputs;
+            for (uint8_t i = 0; i < outputs; i++) {
+                mSegments[i].pin = i == 0 ? PIN_RGB_DATA : PIN_RGB_DATA2;
+                mSegments[i].start = (uint32_t) NUM_LEDS * i / outputs;
+                mSegments[i].length = (uint32_t) NUM_LEDS * (i + 1) / outputs - mSegments[i].start;
+            }
+        }
+
+        /**
+         * Outputs run in parallel, the frame is sent once the longest one has finished.
+         */
+        double showMicros() const
+        {
+            double longest = 0;
+            for (uint8_t i = 0; i < mNumSegments; i++) {
+                longest = wireMicros[i] > longest ? wireMicros[i] : longest;
+            }
+            return longest;
+        }
+
+        virtual void begin(CRGB *frame) {}
+
+        virtual uint8_t numSegments() const { return mNumSegments; }
+
+        virtual const OutputSegment &segment(uint8_t index) const { return mSegments[index]; }
+
+        virtual void setCorrection(const CRGB &correction) {}
+
+        virtual void setDither(uint8_t ditherMode) {}
+
+        virtual void show(CRGB *frame, uint8_t brightness)
+        {
+            for (uint8_t i = 0; i < mNumSegments; i++) {
+                memcpy(pixels[i], frame + mSegments[i].start, sizeof(CRGB) * mSegments[i].length);
+                wireMicros[i] = mSegments[i].length * WIRE_MICROS_PER_PIXEL + WIRE_LATCH_MICROS;
+            }
+            shows++;
+        }
+};
+
+/**
+ * Check that the segments cover the strip once, in order.
+ */
+static bool checkTiling(const LEDOutput &output)
+{
+    uint32_t next = 0;
+    for (uint8_t i = 0; i < output.numSegments(); i++) {
+        if (output.segment(i).start != next) {
+            return false;
+        }
+        next += output.segment(i).length;
+    }
+    return next == NUM_LEDS;
+}
+
+/**
+ * Frame through FastLEDOutput on the host FastLED controllers, compared pin by pin.
+ */
+static void runFastLEDMapping()
+{
+    static FastLEDOutput<PIN_RGB_DATA, PIN_RGB_DATA2> output;
+    static CRGB frame[NUM_LEDS];
+
+    for (int i = 0; i < NUM_LEDS; i++) {
+        frame[i] = CRGB(i & 0xFF, i >> 8, 255 - (i & 0xFF));
+    }
+
+    int firstController = FastLED.count();
+    output.begin(frame);
+    output.setCorrection(CRGB(UncorrectedColor));
+    output.show(frame, 255);
+
+    int mismatches = 0;
+    for (uint8_t s = 0; s < output.numSegments(); s++) {
+        const OutputSegment &segment = output.segment(s);
+
+        size_t length;
+        const uint8_t *wire = native::ledWireData(firstController + s, length);
+        if (length != segment.length * 3u) {
+            mismatches += segment.length;
+            continue;
+        }
+        for (int i = 0; i < segment.length; i++) {
+            // Strip is wired in GRB order
+            const CRGB &pixel = frame[segment.start + i];
+            if (wire[i * 3] != pixel.g || wire[i * 3 + 1] != pixel.r || wire[i * 3 + 2] != pixel.b) {
+                mismatches++;
+            }
+        }
+    }
+
+    bool tiled = checkTiling(output);
+    benchCheck(tiled && mismatches == 0);
+
+    printf("%-24s %u pins, pin %u [%u, %u), pin %u [%u, %u), %s, mismatches %d\n", "FastLEDOutput",
+           output.numSegments(),
+           output.segment(0).pin, output.segment(0).start, output.segment(0).start + output.segment(0).length,
+           output.segment(1).pin, output.segment(1).start, output.segment(1).start + output.segment(1).length,
+           tiled ? "tiled" : "NOT TILED", mismatches);
+}
+
+/**
+ * Pixels of the second half which differ from the first half sent in reverse.
+ */
+static int countMirrorMismatches(const MockOutput &output)
+{
+    const OutputSegment &first = output.segment(0);
+    const OutputSegment &second = output.segment(1);
+    int mismatches = 0;
+
+    for (int i = 0; i < second.length; i++) {
+        if (first.length != second.length || output.pixels[1][i] != output.pixels[0][first.length - 1 - i]) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+void benchOutput(const BenchOptions &options)
+{
+    static MockOutput output;
+
+    LEDDriver &LEDs = benchOutputLEDs(output);
+
+    LEDs.enableLEDStrip(true, false);
+    LEDs.setHSV(0, 255, 255, false);
+    LEDs.setTransition(0, false);
+
+    benchPrintHeader("output (ns per frame)");
+
+    runFastLEDMapping();
+
+    // Mirrored effect, so that both halves carry the same pixels in opposite directions
+    LEDs.setRGBMode(RGB_FIRE, false);
+
+    for (uint8_t outputs = 1; outputs <= MAX_OUTPUTS; outputs++) {
+        output.split(outputs);
+
+        for (int i = 0; i < options.warmupFrames; i++) {
+            native::advanceMillis(LED_FRAME_PERIOD_MS);
+            LEDs.loop();
+        }
+
+        uint32_t shows = output.shows;
+
+        BenchTimer timer;
+        timer.start();
+        for (int i = 0; i < options.frames; i++) {
+            native::advanceMillis(LED_FRAME_PERIOD_MS);
+            LEDs.loop();
+        }
+        timer.stop();
+
+        char extra[96];
+        int length = snprintf(extra, sizeof(extra), "shows/frame %.2f  wire", (double) (output.shows - shows) / options.frames);
+        for (uint8_t i = 0; i < outputs; i++) {
+            length += snprintf(extra + length, sizeof(extra) - length, "%s%.0f", i ? "/" : " ", output.wireMicros[i]);
+        }
+        length += snprintf(extra + length, sizeof(extra) - length, " us  show %.0f us", output.showMicros());
+        if (outputs == 2) {
+            int mismatches = countMirrorMismatches(output);
+            benchCheck(mismatches == 0);
+            snprintf(extra + length, sizeof(extra) - length, "  mirror mismatches %d", mismatches);
+        }
+
+        benchPrintRow(outputs == 1 ? "single pin" : "split halves", timer, options.frames, extra);
+    }
+}
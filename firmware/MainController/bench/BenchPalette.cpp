@@ -0,0 +1,76 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Per-pixel palette lookup: interpolating ColorFromPalette() against the expanded palette cache.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <stdio.h>
+
+#include <FastLED.h>
+
+#include "Effects.h"
+
+// Not static, so the kernels are not optimized away
+CRGB paletteLEDs[NUM_LEDS];
+static EffectContext ctx;
+
+void benchPalette(const BenchOptions &options)
+{
+    const CRGBPalette16 palette = PartyColors_p;
+
+    benchPrintHeader("palette (ns per frame, BPM kernel)");
+
+    BenchTimer timer;
+    timer.start();
+    for (int f = 0; f < options.frames; f++) {
+        ctx.setPalette(palette);
+    }
+    timer.stop();
+    benchPrintRow("expand 256 entries", timer, options.frames);
+
+    // The timer sums up all start/stop pairs, restart it for each case
+    timer = BenchTimer();
+    timer.start();
+    for (int f = 0; f < options.frames; f++) {
+        uint8_t hue = f;
+        uint8_t beat = f * 3;
+        for (int i = 0; i < NUM_LEDS; i++) {
+            paletteLEDs[i] = ColorFromPalette(palette, hue + (i*2), beat - hue + (i*10));
+        }
+    }
+    timer.stop();
+    benchPrintRow("ColorFromPalette", timer, options.frames);
+
+    timer = BenchTimer();
+    timer.start();
+    for (int f = 0; f < options.frames; f++) {
+        uint8_t hue = f;
+        uint8_t beat = f * 3;
+        for (int i = 0; i < NUM_LEDS; i++) {
+            paletteLEDs[i] = ctx.paletteColor(hue + (i*2), beat - hue + (i*10));
+        }
+    }
+    timer.stop();
+
+    // The cache must produce exactly the same colors
+    int mismatches = 0;
+    for (int index = 0; index < 256; index++) {
+        for (int brightness = 0; brightness < 256; brightness++) {
+            if (ColorFromPalette(palette, index, brightness) != ctx.paletteColor(index, brightness)) {
+                mismatches++;
+            }
+        }
+    }
+
+    benchCheck(mismatches == 0);
+
+    char extra[32];
+    snprintf(extra, sizeof(extra), "mismatches %d", mismatches);
+    benchPrintRow("palette cache", timer, options.frames, extra);
+}
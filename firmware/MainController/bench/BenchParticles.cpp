@@ -0,0 +1,80 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Particle pool: cost of a simulation step and of rendering, by number of live particles.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <stdio.h>
+
+#include "config.h"
+#include "Particles.h"
+
+static const int32_t GRAVITY = 200 << 8;
+static const uint8_t BOUNCE = 230;
+
+/**
+ * Top the pool up with bouncing particles, so that every frame moves the same number of them.
+ */
+template<uint16_t Capacity>
+static void refill(ParticlePool<Capacity> &pool)
+{
+    while (!pool.isFull()) {
+        pool.spawn(random16(NUM_LEDS / 2) << 8, (int32_t) random16(100 << 8) - (50 << 8), PARTICLE_IMMORTAL,
+                   CHSV(random8(), 255, 255));
+    }
+}
+
+template<uint16_t Capacity>
+static void runPool(const BenchOptions &options)
+{
+    static ParticlePool<Capacity> pool;
+    static CRGB leds[NUM_LEDS];
+
+    pool.clear();
+    refill(pool);
+
+    BenchTimer stepTimer;
+    BenchTimer renderTimer;
+    uint32_t removed = 0;
+
+    for (int f = 0; f < options.frames; f++) {
+        stepTimer.start();
+        pool.step(LED_FRAME_PERIOD_MS, GRAVITY, BOUNCE, NUM_LEDS);
+        stepTimer.stop();
+
+        removed += Capacity - pool.count();
+        refill(pool);
+
+        renderTimer.start();
+        fadeToBlackBy(leds, NUM_LEDS, 64);
+        pool.render(leds, NUM_LEDS);
+        renderTimer.stop();
+    }
+
+    char name[32];
+    char extra[64];
+
+    snprintf(name, sizeof(name), "step, %u particles", Capacity);
+    snprintf(extra, sizeof(extra), "%.1f ns/particle  removed %u  pool %u bytes",
+             stepTimer.nanosPer(options.frames) / Capacity, removed, (unsigned) sizeof(pool));
+    benchPrintRow(name, stepTimer, options.frames, extra);
+
+    snprintf(name, sizeof(name), "render, %u particles", Capacity);
+    snprintf(extra, sizeof(extra), "%.1f ns/particle  including the trail fade", renderTimer.nanosPer(options.frames) / Capacity);
+    benchPrintRow(name, renderTimer, options.frames, extra);
+}
+
+void benchParticles(const BenchOptions &options)
+{
+    benchPrintHeader("particles (ns per frame)");
+
+    runPool<16>(options);
+    runPool<64>(options);
+    runPool<256>(options);
+}
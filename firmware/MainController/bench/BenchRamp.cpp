@@ -0,0 +1,147 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Color and intensity ramps: largest output step per frame for a burst of keypad
+ * intensity steps, with and without easing.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <NativeHost.h>
+
+#include <commands.h>
+
+#include "LED.h"
+
+// Keypad changes the intensity in steps of 32, sent as fast as the buttons are pressed
+static const int KEYPAD_STEP = 32;
+static const int KEYPAD_STEPS = 7;
+static const uint32_t KEYPAD_INTERVAL_MS = 60;
+
+// Time to wait for the ramps to settle after the burst
+static const uint32_t SETTLE_MS = 2000;
+
+struct RampResult
+{
+    // Largest change of an output between two frames
+    int maxStep;
+    // Time from the first command until the output reached the final value
+    uint32_t settleMillis;
+    int frames;
+};
+
+static int wireByte()
+{
+    size_t length;
+    const uint8_t *wire = benchWireData(length);
+    // Green channel of the first pixel
+    return length > 0 ? wire[0] : -1;
+}
+
+static int lampValue()
+{
+    return LAMP_PWM_MAX - native::analogValue(PIN_LAMP1);
+}
+
+/**
+ * Step the intensity down and back up, reading the output after every frame.
+ */
+static RampResult runSteps(LEDDriver &LEDs, bool lamps, BenchTimer &timer)
+{
+    RampResult result = { 0, 0, 0 };
+    int previous = lamps ? lampValue() : wireByte();
+    int start = previous;
+    uint32_t elapsed = 0;
+    uint32_t lastChange = 0;
+
+    for (int i = 0; i < KEYPAD_STEPS * 2; i++) {
+        int level = i < KEYPAD_STEPS ? 255 - (i + 1) * KEYPAD_STEP : 255 - (KEYPAD_STEPS * 2 - i - 1) * KEYPAD_STEP;
+        if (lamps) {
+            LEDs.setIntensity(level, false);
+        } else {
+            LEDs.setHSV(0, 0, level, false);
+        }
+
+        for (uint32_t t = 0; t < (i < KEYPAD_STEPS * 2 - 1 ? KEYPAD_INTERVAL_MS : SETTLE_MS); t += LED_MIN_FRAME_PERIOD_MS) {
+            native::advanceMillis(LED_MIN_FRAME_PERIOD_MS);
+            elapsed += LED_MIN_FRAME_PERIOD_MS;
+
+            timer.start();
+            LEDs.loop();
+            timer.stop();
+            result.frames++;
+
+            int value = lamps ? lampValue() : wireByte();
+            int step = abs(value - previous);
+            if (step > result.maxStep) {
+                result.maxStep = step;
+            }
+            if (value != previous) {
+                lastChange = elapsed;
+            }
+            previous = value;
+        }
+    }
+    result.settleMillis = previous == start ? lastChange : 0;
+    return result;
+}
+
+void benchRamp(const BenchOptions &options)
+{
+    LEDDriver &LEDs = benchLEDs();
+
+    LEDs.enableLEDStrip(true, false);
+    LEDs.enableLamps(true, false);
+    LEDs.enableDither(false);
+    LEDs.setRGBMode(RGB_ON, false);
+    LEDs.setIntensity(255, false);
+    LEDs.setHSV(0, 0, 255, false);
+
+    for (int i = 0; i < options.warmupFrames; i++) {
+        native::advanceMillis(LED_FRAME_PERIOD_MS);
+        LEDs.loop();
+    }
+
+    benchPrintHeader("ramp (ns per loop)");
+
+    uint16_t rampTime = LEDs.rampTime();
+    static const uint16_t RAMP_TIMES[] = { 0, LED_RAMP_MS };
+
+    for (int lamps = 0; lamps < 2; lamps++) {
+        for (uint16_t ramp : RAMP_TIMES) {
+            LEDs.setRampTime(ramp);
+
+            BenchTimer timer;
+            RampResult result = runSteps(LEDs, lamps, timer);
+
+            char extra[64];
+            snprintf(extra, sizeof(extra), "max step %d/%d  settled after %u ms", result.maxStep,
+                     lamps ? LAMP_PWM_MAX : 255, result.settleMillis);
+
+            char name[32];
+            snprintf(name, sizeof(name), "%s ramp %u ms", lamps ? "lamps" : "strip", ramp);
+            benchPrintRow(name, timer, result.frames, extra);
+        }
+    }
+
+    LEDs.setRampTime(rampTime);
+
+    // Output levels a ramp passes through in the bottom tenth of the intensity range
+    int levels = 0;
+    int previous = -1;
+    for (uint32_t intensity = 0; intensity <= (256 * 255) / 10; intensity++) {
+        int duty = lampDuty(intensity);
+        if (duty != previous) {
+            levels++;
+            previous = duty;
+        }
+    }
+    printf("%-24s %d duty levels below 10%% (8 bit linear: %d)\n", "lamp curve", levels, 255 / 10 + 1);
+}
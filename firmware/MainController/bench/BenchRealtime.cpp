@@ -0,0 +1,346 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Realtime input: latency from sending a frame over loopback UDP or the serial console
+ * until it is shown, checked against the pixels that were sent.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <NativeHost.h>
+
+#include <commands.h>
+
+#include "LED.h"
+#include "CommandLine.h"
+#include "AdalightInput.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+static const size_t DDP_HEADER_LENGTH = 10;
+// Whole pixels per packet, as sent by common DDP senders
+static const size_t DDP_MAX_DATA_LENGTH = 480 * 3;
+static const size_t E131_HEADER_LENGTH = 126;
+static const size_t E131_UNIVERSE_BYTES = 170 * 3;
+
+// Large enough for one full frame in either protocol
+static uint8_t packetBuffer[1500 * 2];
+
+typedef int (*SendFrame)(int sender, const CRGB *frame);
+
+/**
+ * Test pattern which changes every pixel on every frame.
+ */
+static void buildFrame(CRGB *frame, int index)
+{
+    for (int i = 0; i < NUM_LEDS; i++) {
+        frame[i] = CRGB(i + index, i * 3 + index, 255 - i - index);
+    }
+}
+
+static int sendTo(int sender, uint16_t port, const uint8_t *data, size_t length)
+{
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    return sendto(sender, data, length, 0, (struct sockaddr*) &addr, sizeof(addr));
+}
+
+/**
+ * Send length bytes of the frame starting at offset in one DDP packet.
+ */
+static bool sendDDPPacket(int sender, const CRGB *frame, size_t offset, size_t length, bool push)
+{
+    static uint8_t sequence = 0;
+
+    const uint8_t *pixels = (const uint8_t*) frame;
+    uint8_t *packet = packetBuffer;
+
+    // Version 1, push flag, RGB 8 bit, display id 1
+    memset(packet, 0, DDP_HEADER_LENGTH);
+    packet[0] = push ? 0x41 : 0x40;
+    packet[1] = ++sequence & 0x0F;
+    packet[2] = 0x0B;
+    packet[3] = 1;
+    packet[4] = offset >> 24;
+    packet[5] = (offset >> 16) & 0xFF;
+    packet[6] = (offset >> 8) & 0xFF;
+    packet[7] = offset & 0xFF;
+    packet[8] = length >> 8;
+    packet[9] = length & 0xFF;
+    memcpy(packet + DDP_HEADER_LENGTH, pixels + offset, length);
+
+    return sendTo(sender, REALTIME_DDP_PORT, packet, DDP_HEADER_LENGTH + length) > 0;
+}
+
+static int sendDDP(int sender, const CRGB *frame)
+{
+    size_t frameBytes = NUM_LEDS * 3;
+    int sent = 0;
+
+    for (size_t offset = 0; offset < frameBytes; offset += DDP_MAX_DATA_LENGTH) {
+        size_t length = frameBytes - offset < DDP_MAX_DATA_LENGTH ? frameBytes - offset : DDP_MAX_DATA_LENGTH;
+
+        // Push on the last packet
+        if (sendDDPPacket(sender, frame, offset, length, offset + length == frameBytes)) {
+            sent++;
+        }
+    }
+    return sent;
+}
+
+static void writeU16(uint8_t *data, uint16_t value)
+{
+    data[0] = value >> 8;
+    data[1] = value & 0xFF;
+}
+
+static int sendE131(int sender, const CRGB *frame)
+{
+    static const uint8_t ACN_ID[12] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+    static uint8_t sequence = 0;
+
+    const uint8_t *pixels = (const uint8_t*) frame;
+    size_t frameBytes = NUM_LEDS * 3;
+    int sent = 0;
+
+    sequence++;
+    for (size_t offset = 0; offset < frameBytes; offset += E131_UNIVERSE_BYTES) {
+        size_t slots = frameBytes - offset < E131_UNIVERSE_BYTES ? frameBytes - offset : E131_UNIVERSE_BYTES;
+        size_t length = E131_HEADER_LENGTH + slots;
+        uint8_t *packet = packetBuffer;
+
+        memset(packet, 0, E131_HEADER_LENGTH);
+        writeU16(packet, 0x0010);
+        memcpy(packet + 4, ACN_ID, sizeof(ACN_ID));
+        writeU16(packet + 16, 0x7000 | (length - 16));
+        packet[21] = 0x04;
+        writeU16(packet + 38, 0x7000 | (length - 38));
+        packet[43] = 0x02;
+        strcpy((char*) packet + 44, "bench");
+        packet[108] = 100;
+        packet[111] = sequence;
+        writeU16(packet + 113, REALTIME_E131_UNIVERSE + offset / E131_UNIVERSE_BYTES);
+        writeU16(packet + 115, 0x7000 | (length - 115));
+        packet[117] = 0x02;
+        packet[118] = 0xA1;
+        writeU16(packet + 121, 1);
+        writeU16(packet + 123, slots + 1);
+        memcpy(packet + E131_HEADER_LENGTH, pixels + offset, slots);
+
+        if (sendTo(sender, REALTIME_E131_PORT, packet, length) > 0) {
+            sent++;
+        }
+    }
+    return sent;
+}
+
+/**
+ * Count pixels on the wire which differ from the frame sent, with full brightness and the strip correction.
+ */
+static int countMismatches(const CRGB *frame)
+{
+    size_t length;
+    const uint8_t *wire = benchWireData(length);
+    if (length != NUM_LEDS * 3) {
+        return NUM_LEDS;
+    }
+
+    CRGB correction(TypicalLEDStrip);
+    int mismatches = 0;
+
+    for (int i = 0; i < NUM_LEDS; i++) {
+        // Strip is wired in GRB order
+        if (wire[i * 3]     != scale8(frame[i].g, correction.g) ||
+            wire[i * 3 + 1] != scale8(frame[i].r, correction.r) ||
+            wire[i * 3 + 2] != scale8(frame[i].b, correction.b))
+        {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static void runCase(LEDDriver &LEDs, const char *name, int sender, SendFrame send, const BenchOptions &options)
+{
+    static CRGB frame[NUM_LEDS];
+
+    uint32_t shows = native::ledShowCount();
+    uint32_t packets = LEDs.realtimeInput().packetCount();
+    int sent = 0;
+
+    BenchTimer timer;
+    timer.start();
+    for (int i = 0; i < options.frames; i++) {
+        buildFrame(frame, i);
+        sent += send(sender, frame);
+
+        native::advanceMillis(LED_MIN_FRAME_PERIOD_MS);
+        LEDs.loop();
+    }
+    timer.stop();
+
+    uint32_t received = LEDs.realtimeInput().packetCount() - packets;
+    int mismatches = countMismatches(frame);
+    benchCheck(received == (uint32_t) sent && mismatches == 0);
+
+    char extra[96];
+    snprintf(extra, sizeof(extra), "shows/frame %.2f  packets %u/%d  mismatches %d",
+             (double) (native::ledShowCount() - shows) / options.frames, received, sent, mismatches);
+
+    benchPrintRow(name, timer, options.frames, extra);
+}
+
+/**
+ * A DDP frame in two packets, only the second one pushes the frame. Nothing may be shown before it arrives.
+ */
+static void checkPush(LEDDriver &LEDs, int sender)
+{
+    static CRGB frame[NUM_LEDS];
+    static uint8_t before[NUM_LEDS * 3];
+
+    size_t length;
+    memcpy(before, benchWireData(length), sizeof(before));
+
+    buildFrame(frame, 100);
+    size_t half = NUM_LEDS / 2 * 3;
+    sendDDPPacket(sender, frame, 0, half, false);
+    native::advanceMillis(LED_MIN_FRAME_PERIOD_MS);
+    LEDs.loop();
+
+    const uint8_t *wire = benchWireData(length);
+    bool early = length != sizeof(before) || memcmp(wire, before, sizeof(before)) != 0;
+
+    sendDDPPacket(sender, frame, half, NUM_LEDS * 3 - half, true);
+    native::advanceMillis(LED_MIN_FRAME_PERIOD_MS);
+    LEDs.loop();
+
+    int mismatches = countMismatches(frame);
+    benchCheck(!early && mismatches == 0);
+
+    printf("%-24s %s, mismatches %d\n", "ddp push", early ? "SHOWN BEFORE PUSH" : "held until the push", mismatches);
+}
+
+/**
+ * Serial frames through the command line, the injection into the host serial port is not measured.
+ */
+static void runAdalight(LEDDriver &LEDs, const BenchOptions &options)
+{
+    static CommandLine cmdline;
+    static AdalightInput adalight(LEDs);
+    static CRGB frame[NUM_LEDS];
+
+    cmdline.begin();
+    cmdline.setStreamParser(&adalight);
+
+    uint32_t consoleBaud = Serial.baudRate();
+    uint32_t shows = native::ledShowCount();
+    uint32_t frames = adalight.frameCount();
+
+    uint8_t header[6] = { 'A', 'd', 'a', (NUM_LEDS - 1) >> 8, (NUM_LEDS - 1) & 0xFF, 0 };
+    header[5] = header[3] ^ header[4] ^ 0x55;
+
+    BenchTimer timer;
+    for (int i = 0; i < options.frames; i++) {
+        buildFrame(frame, i);
+        Serial.inject(header, sizeof(header));
+        Serial.inject((const uint8_t*) frame, sizeof(frame));
+
+        timer.start();
+        // Header, then the pixels once the stream owns the input
+        cmdline.loop();
+        cmdline.loop();
+
+        native::advanceMillis(LED_MIN_FRAME_PERIOD_MS);
+        LEDs.loop();
+        timer.stop();
+    }
+    uint32_t acked = adalight.frameCount() - frames;
+    int mismatches = countMismatches(frame);
+    benchCheck(acked == (uint32_t) options.frames && mismatches == 0);
+
+    char extra[96];
+    snprintf(extra, sizeof(extra), "shows/frame %.2f  acked %u/%d  mismatches %d",
+             (double) (native::ledShowCount() - shows) / options.frames, acked, options.frames, mismatches);
+
+    benchPrintRow("adalight", timer, options.frames, extra);
+
+    // A header for more pixels than the strip has, the largest count would wrap around in 16 bit
+    uint8_t oversized[6] = { 'A', 'd', 'a', 0xFF, 0xFF, 0x55 };
+    acked = adalight.frameCount();
+    Serial.inject(oversized, sizeof(oversized));
+    Serial.inject(header, sizeof(header));
+    Serial.inject((const uint8_t*) frame, sizeof(frame));
+    for (int i = 0; i < 4; i++) {
+        cmdline.loop();
+    }
+    native::advanceMillis(LED_MIN_FRAME_PERIOD_MS);
+    LEDs.loop();
+
+    printf("%-24s %s\n", "oversized header",
+           benchCheck(adalight.frameCount() == acked + 1) ? "rejected, next frame received" : "FAILED");
+
+    // Console comes back once the sender stops, the rate never changes
+    native::advanceMillis(SERIAL_STREAM_TIMEOUT_MS);
+    cmdline.loop();
+
+    printf("%-24s %s\n", "serial timeout",
+           benchCheck(!cmdline.isStreaming() && Serial.baudRate() == consoleBaud) ? "returned to console" : "FAILED");
+}
+
+void benchRealtime(const BenchOptions &options)
+{
+    LEDDriver &LEDs = benchLEDs();
+
+    // Realtime input is started once the network is up
+    native::setWiFiConnected(true);
+
+    LEDs.enableLEDStrip(true, false);
+    LEDs.setHSV(0, 255, 255, false);
+    LEDs.setRGBMode(RGB_CYCLE, false);
+
+    for (int i = 0; i < options.warmupFrames; i++) {
+        native::advanceMillis(LED_FRAME_PERIOD_MS);
+        LEDs.loop();
+    }
+
+    int sender = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sender < 0 || !LEDs.realtimeInput().isStarted()) {
+        benchCheck(false);
+        printf("\nrealtime: could not set up the loopback sockets\n");
+        return;
+    }
+
+    benchPrintHeader("realtime (ns per frame, send to show)");
+
+    runCase(LEDs, "ddp", sender, sendDDP, options);
+    checkPush(LEDs, sender);
+    runCase(LEDs, "e1.31", sender, sendE131, options);
+    runAdalight(LEDs, options);
+
+    // The selected mode takes over again after the timeout
+    uint32_t shows = native::ledShowCount();
+    native::advanceMillis(REALTIME_TIMEOUT_MS);
+    LEDs.loop();
+    native::advanceMillis(LED_FRAME_PERIOD_MS);
+    LEDs.loop();
+
+    printf("%-24s %s, %u invalid packets\n", "timeout",
+           benchCheck(!LEDs.realtimeInput().isActive() && native::ledShowCount() > shows) ? "returned to mode" : "FAILED",
+           LEDs.realtimeInput().invalidCount());
+
+    close(sender);
+}
@@ -0,0 +1,86 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host benchmark runner for the native environment.
+ *
+ * Usage: program [-n <frames>] [suite ...]
+ *
+ * Exits with 1 if any correctness check of the selected suites failed.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <NativeHost.h>
+
+#include "Bench.h"
+
+struct BenchSuite
+{
+    const char *name;
+    void (*run)(const BenchOptions &options);
+};
+
+static const BenchSuite SUITES[] = {
+    { "effects", benchEffects },
+    { "palette", benchPalette },
+    { "realtime", benchRealtime },
+    { "dither", benchDither },
+    { "blend", benchBlend },
+    { "ramp", benchRamp },
+    { "layout", benchLayout },
+    { "output", benchOutput },
+    { "geometry", benchGeometry },
+    { "compose", benchCompose },
+    { "particles", benchParticles },
+    { "noise", benchNoise },
+    { "beat", benchBeat },
+    { "audio", benchAudio }
+};
+
+static const int NUM_SUITES = sizeof(SUITES) / sizeof(SUITES[0]);
+
+static bool isSelected(const char *name, int argc, char **argv, int firstSuite)
+{
+    if (firstSuite >= argc) {
+        return true;
+    }
+    for (int i = firstSuite; i < argc; i++) {
+        if (strcmp(argv[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions options;
+    int firstSuite = 1;
+
+    if (argc > 2 && strcmp(argv[1], "-n") == 0) {
+        options.frames = atoi(argv[2]);
+        firstSuite = 3;
+    }
+
+    // Keep the driver logging out of the results
+    native::muteSerial(true);
+
+    for (int i = 0; i < NUM_SUITES; i++) {
+        if (isSelected(SUITES[i].name, argc, argv, firstSuite)) {
+            SUITES[i].run(options);
+        }
+    }
+
+    int failures = benchFailureCount();
+    if (failures > 0) {
+        printf("\n%d checks FAILED\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,276 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host implementation of the Arduino core shims.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Arduino.h"
+#include "NativeHost.h"
+
+#include <stdarg.h>
+#include <time.h>
+
+#include <vector>
+
+static const int NUM_PINS = 40;
+
+static uint64_t simMicros = 0;
+static int pinValues[NUM_PINS];
+static int analogValues[NUM_PINS];
+static bool serialMuted = false;
+
+HardwareSerial Serial(0);
+EspClass ESP;
+const IPAddress INADDR_NONE(0, 0, 0, 0);
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin < NUM_PINS) {
+        pinValues[pin] = value;
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pin < NUM_PINS ? pinValues[pin] : LOW;
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+    if (pin < NUM_PINS) {
+        analogValues[pin] = value;
+    }
+}
+
+void analogWriteFrequency(double freq)
+{
+}
+
+void analogWriteResolution(uint8_t bits)
+{
+}
+
+unsigned long millis()
+{
+    return simMicros / 1000;
+}
+
+unsigned long micros()
+{
+    return simMicros;
+}
+
+void delay(uint32_t ms)
+{
+    simMicros += (uint64_t) ms * 1000;
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    simMicros += us;
+}
+
+long random(long max)
+{
+    return max > 0 ? rand() % max : 0;
+}
+
+long random(long min, long max)
+{
+    return max > min ? min + rand() % (max - min) : min;
+}
+
+void randomSeed(unsigned long seed)
+{
+    srand(seed);
+}
+
+uint32_t EspClass::getCycleCount()
+{
+    // Emulate the 240 MHz CCOUNT register from the wall clock
+    return (uint32_t) (native::wallNanos() * 240 / 1000);
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--) {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::write(const char *str)
+{
+    return write((const uint8_t*) str, strlen(str));
+}
+
+size_t Print::print(const char *str)
+{
+    return write(str);
+}
+
+size_t Print::print(int value, int base)
+{
+    return print(String(value, base));
+}
+
+size_t Print::print(unsigned int value, int base)
+{
+    return print(String(value, base));
+}
+
+size_t Print::print(long value, int base)
+{
+    return print(String(value, base));
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    return print(String(value, base));
+}
+
+size_t Print::print(double value, int digits)
+{
+    return print(String((float) value, (unsigned int) digits));
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char buf[256];
+    va_list args;
+
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+
+    if (len < 0) {
+        return 0;
+    }
+    if ((size_t) len >= sizeof(buf)) {
+        std::vector<char> big(len + 1);
+        va_start(args, format);
+        vsnprintf(big.data(), big.size(), format, args);
+        va_end(args);
+        return write((const uint8_t*) big.data(), len);
+    }
+    return write((const uint8_t*) buf, len);
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin)
+{
+    mBaudRate = baud;
+}
+
+int HardwareSerial::read()
+{
+    if (mRxBuffer.empty()) {
+        return -1;
+    }
+    uint8_t c = mRxBuffer.front();
+    mRxBuffer.pop_front();
+    return c;
+}
+
+size_t HardwareSerial::readBytes(uint8_t *buffer, size_t length)
+{
+    size_t n = 0;
+    while (n < length && !mRxBuffer.empty()) {
+        buffer[n++] = mRxBuffer.front();
+        mRxBuffer.pop_front();
+    }
+    return n;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    // Only the console port is forwarded to stdout
+    if (mPort == 0 && !serialMuted) {
+        fputc(c, stdout);
+    }
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (mPort == 0 && !serialMuted) {
+        fwrite(buffer, 1, size, stdout);
+    }
+    return size;
+}
+
+void HardwareSerial::inject(const uint8_t *data, size_t length)
+{
+    mRxBuffer.insert(mRxBuffer.end(), data, data + length);
+}
+
+void HardwareSerial::inject(const char *str)
+{
+    inject((const uint8_t*) str, strlen(str));
+}
+
+bool IPAddress::operator==(const IPAddress &rhs) const
+{
+    return memcmp(mAddress, rhs.mAddress, sizeof(mAddress)) == 0;
+}
+
+String IPAddress::toString() const
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", mAddress[0], mAddress[1], mAddress[2], mAddress[3]);
+    return String(buf);
+}
+
+namespace native {
+
+    void setMicros(uint64_t us)
+    {
+        simMicros = us;
+    }
+
+    void advanceMicros(uint64_t us)
+    {
+        simMicros += us;
+    }
+
+    void advanceMillis(uint32_t ms)
+    {
+        simMicros += (uint64_t) ms * 1000;
+    }
+
+    uint64_t currentMicros()
+    {
+        return simMicros;
+    }
+
+    uint64_t wallNanos()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+    }
+
+    int pinValue(uint8_t pin)
+    {
+        return pin < NUM_PINS ? pinValues[pin] : LOW;
+    }
+
+    int analogValue(uint8_t pin)
+    {
+        return pin < NUM_PINS ? analogValues[pin] : 0;
+    }
+
+    void muteSerial(bool mute)
+    {
+        serialMuted = mute;
+    }
+
+}
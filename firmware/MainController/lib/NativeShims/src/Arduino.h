@@ -0,0 +1,75 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host replacement for the subset of the Arduino-ESP32 core used by the controller.
+ * Time is simulated, see NativeHost.h.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+#include <functional>
+
+#include "WString.h"
+#include "HardwareSerial.h"
+#include "IPAddress.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+static const uint8_t LOW  = 0x0;
+static const uint8_t HIGH = 0x1;
+
+static const uint8_t INPUT        = 0x01;
+static const uint8_t OUTPUT       = 0x03;
+static const uint8_t INPUT_PULLUP = 0x05;
+
+void pinMode(uint8_t pin, uint8_t mode);
+
+void digitalWrite(uint8_t pin, uint8_t value);
+
+int digitalRead(uint8_t pin);
+
+void analogWrite(uint8_t pin, int value);
+
+void analogWriteFrequency(double freq);
+
+void analogWriteResolution(uint8_t bits);
+
+unsigned long millis();
+
+unsigned long micros();
+
+void delay(uint32_t ms);
+
+void delayMicroseconds(uint32_t us);
+
+long random(long max);
+
+long random(long min, long max);
+
+void randomSeed(unsigned long seed);
+
+class EspClass
+{
+    public:
+        uint32_t getCycleCount();
+
+        uint32_t getCpuFreqMHz() { return 240; }
+
+        uint32_t getFreeHeap() { return 0; }
+};
+
+extern EspClass ESP;
@@ -0,0 +1,469 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host implementation of the FastLED shims.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "FastLED.h"
+#include "NativeHost.h"
+
+CFastLED FastLED;
+
+uint16_t rand16seed = 1337;
+
+const TProgmemRGBPalette16 CloudColors_p = {
+    0x0000FF, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B,
+    0x0000FF, 0x00008B, 0x87CEEB, 0x87CEEB, 0xADD8E6, 0xFFFFFF, 0xADD8E6, 0x87CEEB
+};
+
+const TProgmemRGBPalette16 LavaColors_p = {
+    0x000000, 0x800000, 0x000000, 0x800000, 0x8B0000, 0x8B0000, 0x800000, 0x8B0000,
+    0x8B0000, 0x8B0000, 0xFF0000, 0xFFA500, 0xFFFFFF, 0xFFA500, 0xFF0000, 0x8B0000
+};
+
+const TProgmemRGBPalette16 OceanColors_p = {
+    0x191970, 0x00008B, 0x191970, 0x000080, 0x00008B, 0x0000CD, 0x2E8B57, 0x008080,
+    0x5F9EA0, 0x0000FF, 0x008B8B, 0x6495ED, 0x7FFFD4, 0x2E8B57, 0x00FFFF, 0x87CEFA
+};
+
+const TProgmemRGBPalette16 ForestColors_p = {
+    0x006400, 0x006400, 0x556B2F, 0x006400, 0x008000, 0x228B22, 0x6B8E23, 0x008000,
+    0x2E8B57, 0x66CDAA, 0x32CD32, 0x9ACD32, 0x90EE90, 0x7CFC00, 0x66CDAA, 0x228B22
+};
+
+const TProgmemRGBPalette16 RainbowColors_p = {
+    0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00, 0xABAB00, 0x56D500, 0x00FF00, 0x00D52A,
+    0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5, 0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B
+};
+
+const TProgmemRGBPalette16 PartyColors_p = {
+    0x5500AB, 0x84007C, 0xB5004B, 0xE5001B, 0xE81700, 0xB84700, 0xAB7700, 0xABAB00,
+    0xAB5500, 0xDD2200, 0xF2000E, 0xC2003E, 0x8F0071, 0x5F00A1, 0x2F00D0, 0x0007F9
+};
+
+const TProgmemRGBPalette16 HeatColors_p = {
+    0x000000, 0x330000, 0x660000, 0x990000, 0xCC0000, 0xFF0000, 0xFF3300, 0xFF6600,
+    0xFF9900, 0xFFCC00, 0xFFFF00, 0xFFFF33, 0xFFFF66, 0xFFFF99, 0xFFFFCC, 0xFFFFFF
+};
+
+int16_t sin16(uint16_t theta)
+{
+    static const uint16_t base[] = { 0, 6393, 12539, 18204, 23170, 27245, 30273, 32137 };
+    static const uint8_t slope[] = { 49, 48, 44, 38, 31, 23, 14, 4 };
+
+    uint16_t offset = (theta & 0x3FFF) >> 3;
+    if (theta & 0x4000) {
+        offset = 2047 - offset;
+    }
+
+    uint8_t section = offset / 256;
+    uint16_t b = base[section];
+    uint8_t m = slope[section];
+
+    uint8_t secoffset8 = (uint8_t) (offset) / 2;
+
+    uint16_t mx = m * secoffset8;
+    int16_t y = mx + b;
+
+    if (theta & 0x8000) {
+        y = -y;
+    }
+    return y;
+}
+
+uint8_t sin8(uint8_t theta)
+{
+    static const uint8_t b_m16_interleave[] = { 0, 49, 49, 41, 90, 27, 117, 10 };
+
+    uint8_t offset = theta;
+    if (theta & 0x40) {
+        offset = (uint8_t) 255 - offset;
+    }
+    offset &= 0x3F;
+
+    uint8_t secoffset = offset & 0x0F;
+    if (theta & 0x40) {
+        secoffset++;
+    }
+
+    uint8_t section = offset >> 4;
+    uint8_t b = b_m16_interleave[section * 2];
+    uint8_t m16 = b_m16_interleave[section * 2 + 1];
+
+    uint8_t mx = (m16 * secoffset) >> 4;
+
+    int8_t y = mx + b;
+    if (theta & 0x80) {
+        y = -y;
+    }
+    y += 128;
+    return y;
+}
+
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb)
+{
+    uint8_t hue = hsv.hue;
+    uint8_t sat = hsv.sat;
+    uint8_t val = hsv.val;
+
+    uint8_t offset = hue & 0x1F;
+    uint8_t offset8 = offset << 3;
+    uint8_t third = scale8(offset8, (256 / 3));
+
+    uint8_t r, g, b;
+
+    if (!(hue & 0x80)) {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) {
+                // red -> orange
+                r = 255 - third; g = third; b = 0;
+            } else {
+                // orange -> yellow
+                r = 171; g = 85 + third; b = 0;
+            }
+        } else {
+            if (!(hue & 0x20)) {
+                // yellow -> green
+                uint8_t twothirds = scale8(offset8, ((256 * 2) / 3));
+                r = 171 - twothirds; g = 170 + third; b = 0;
+            } else {
+                // green -> aqua
+                r = 0; g = 255 - third; b = third;
+            }
+        }
+    } else {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) {
+                // aqua -> blue
+                uint8_t twothirds = scale8(offset8, ((256 * 2) / 3));
+                r = 0; g = 171 - twothirds; b = 85 + twothirds;
+            } else {
+                // blue -> purple
+                r = third; g = 0; b = 255 - third;
+            }
+        } else {
+            if (!(hue & 0x20)) {
+                // purple -> pink
+                r = 85 + third; g = 0; b = 171 - third;
+            } else {
+                // pink -> red
+                r = 170 + third; g = 0; b = 85 - third;
+            }
+        }
+    }
+
+    if (sat != 255) {
+        if (sat == 0) {
+            r = 255; g = 255; b = 255;
+        } else {
+            uint8_t desat = 255 - sat;
+            desat = scale8_video(desat, desat);
+            uint8_t satscale = 255 - desat;
+
+            if (r) r = scale8(r, satscale) + 1;
+            if (g) g = scale8(g, satscale) + 1;
+            if (b) b = scale8(b, satscale) + 1;
+
+            r += desat;
+            g += desat;
+            b += desat;
+        }
+    }
+
+    if (val != 255) {
+        val = scale8_video(val, val);
+        if (val == 0) {
+            r = 0; g = 0; b = 0;
+        } else {
+            if (r) r = scale8(r, val) + 1;
+            if (g) g = scale8(g, val) + 1;
+            if (b) b = scale8(b, val) + 1;
+        }
+    }
+
+    rgb.r = r;
+    rgb.g = g;
+    rgb.b = b;
+}
+
+CHSV rgb2hsv_approximate(const CRGB &rgb)
+{
+    uint8_t maxc = std::max(rgb.r, std::max(rgb.g, rgb.b));
+    uint8_t minc = std::min(rgb.r, std::min(rgb.g, rgb.b));
+    uint8_t delta = maxc - minc;
+
+    if (maxc == 0) {
+        return CHSV(0, 0, 0);
+    }
+    if (delta == 0) {
+        return CHSV(0, 0, maxc);
+    }
+
+    uint8_t sat = (delta * 255) / maxc;
+    int hue;
+    if (maxc == rgb.r) {
+        hue = 0 + (43 * (rgb.g - rgb.b)) / delta;
+    } else if (maxc == rgb.g) {
+        hue = 85 + (43 * (rgb.b - rgb.r)) / delta;
+    } else {
+        hue = 171 + (43 * (rgb.r - rgb.g)) / delta;
+    }
+    return CHSV((uint8_t) hue, sat, maxc);
+}
+
+CRGB ColorFromPalette(const CRGBPalette16 &pal, uint8_t index, uint8_t brightness, TBlendType blendType)
+{
+    uint8_t hi4 = index >> 4;
+    uint8_t lo4 = index & 0x0F;
+
+    const CRGB *entry = &(pal[0]) + hi4;
+
+    uint8_t red1 = entry->red;
+    uint8_t green1 = entry->green;
+    uint8_t blue1 = entry->blue;
+
+    if (lo4 && blendType != NOBLEND) {
+        entry = hi4 == 15 ? &(pal[0]) : entry + 1;
+
+        uint8_t f2 = lo4 << 4;
+        uint8_t f1 = 255 - f2;
+
+        red1 = scale8(red1, f1) + scale8(entry->red, f2);
+        green1 = scale8(green1, f1) + scale8(entry->green, f2);
+        blue1 = scale8(blue1, f1) + scale8(entry->blue, f2);
+    }
+
+    if (brightness != 255) {
+        if (brightness) {
+            brightness++;
+            if (red1) red1 = scale8(red1, brightness);
+            if (green1) green1 = scale8(green1, brightness);
+            if (blue1) blue1 = scale8(blue1, brightness);
+        } else {
+            red1 = 0; green1 = 0; blue1 = 0;
+        }
+    }
+
+    return CRGB(red1, green1, blue1);
+}
+
+void fill_solid(CRGB *leds, int numToFill, const CRGB &color)
+{
+    for (int i = 0; i < numToFill; i++) {
+        leds[i] = color;
+    }
+}
+
+void fill_rainbow(CRGB *leds, int numToFill, uint8_t initialhue, uint8_t deltahue)
+{
+    CHSV hsv(initialhue, 240, 255);
+    for (int i = 0; i < numToFill; i++) {
+        leds[i] = hsv;
+        hsv.hue += deltahue;
+    }
+}
+
+void nscale8(CRGB *leds, uint16_t numLeds, uint8_t scale)
+{
+    for (uint16_t i = 0; i < numLeds; i++) {
+        leds[i].nscale8(scale);
+    }
+}
+
+void fadeToBlackBy(CRGB *leds, uint16_t numLeds, uint8_t fadeBy)
+{
+    nscale8(leds, numLeds, 255 - fadeBy);
+}
+
+CRGB blend(const CRGB &p1, const CRGB &p2, uint8_t amountOfP2)
+{
+    return CRGB(lerp8by8(p1.r, p2.r, amountOfP2),
+                lerp8by8(p1.g, p2.g, amountOfP2),
+                lerp8by8(p1.b, p2.b, amountOfP2));
+}
+
+CRGB HeatColor(uint8_t temperature)
+{
+    CRGB heatcolor;
+
+    uint8_t t192 = scale8_video(temperature, 191);
+    uint8_t heatramp = t192 & 0x3F;
+    heatramp <<= 2;
+
+    if (t192 & 0x80) {
+        heatcolor.r = 255; heatcolor.g = 255; heatcolor.b = heatramp;
+    } else if (t192 & 0x40) {
+        heatcolor.r = 255; heatcolor.g = heatramp; heatcolor.b = 0;
+    } else {
+        heatcolor.r = heatramp; heatcolor.g = 0; heatcolor.b = 0;
+    }
+    return heatcolor;
+}
+
+/* Perlin noise, 8 bit version */
+
+static const uint8_t perm[256] = {
+    151,160,137,91,90,15,131,13,201,95,96,53,194,233,7,225,140,36,103,30,69,142,8,99,37,240,21,10,23,
+    190,6,148,247,120,234,75,0,26,197,62,94,252,219,203,117,35,11,32,57,177,33,88,237,149,56,87,174,20,
+    125,136,171,168,68,175,74,165,71,134,139,48,27,166,77,146,158,231,83,111,229,122,60,211,133,230,220,
+    105,92,41,55,46,245,40,244,102,143,54,65,25,63,161,1,216,80,73,209,76,132,187,208,89,18,169,200,196,
+    135,130,116,188,159,86,164,100,109,198,173,186,3,64,52,217,226,250,124,123,5,202,38,147,118,126,255,
+    82,85,212,207,206,59,227,47,16,58,17,182,189,28,42,223,183,170,213,119,248,152,2,44,154,163,70,221,
+    153,101,155,167,43,172,9,129,22,39,253,19,98,108,110,79,113,224,232,178,185,112,104,218,246,97,228,
+    251,34,242,193,238,210,144,12,191,179,162,241,81,51,145,235,249,14,239,107,49,192,214,31,181,199,
+    106,157,184,84,204,176,115,121,50,45,127,4,150,254,138,236,205,93,222,114,67,29,24,72,243,141,128,
+    195,78,66,215,61,156,180
+};
+
+static inline uint8_t P(int x)
+{
+    return perm[x & 0xFF];
+}
+
+static inline int8_t avg7(int8_t i, int8_t j)
+{
+    return (i >> 1) + (j >> 1) + (i & 0x1);
+}
+
+static inline int8_t grad8(uint8_t hash, int8_t x, int8_t y)
+{
+    int8_t u, v;
+    if (hash & 4) {
+        u = y; v = x;
+    } else {
+        u = x; v = y;
+    }
+    if (hash & 1) {
+        u = -u;
+    }
+    if (hash & 2) {
+        v = -v;
+    }
+    return avg7(u, v);
+}
+
+static inline int8_t lerp7by8(int8_t a, int8_t b, uint8_t frac)
+{
+    if (b > a) {
+        uint8_t delta = b - a;
+        return a + scale8(delta, frac);
+    }
+    uint8_t delta = a - b;
+    return a - scale8(delta, frac);
+}
+
+static int8_t inoise8_raw(uint16_t x, uint16_t y)
+{
+    uint8_t X = x >> 8;
+    uint8_t Y = y >> 8;
+
+    uint8_t A = P(X) + Y;
+    uint8_t AA = P(A);
+    uint8_t AB = P(A + 1);
+    uint8_t B = P(X + 1) + Y;
+    uint8_t BA = P(B);
+    uint8_t BB = P(B + 1);
+
+    uint8_t u = ease8InOutQuad(x);
+    uint8_t v = ease8InOutQuad(y);
+
+    int8_t xx = ((uint8_t) (x) >> 1) & 0x7F;
+    int8_t yy = ((uint8_t) (y) >> 1) & 0x7F;
+    uint8_t N = 0x80;
+
+    int8_t X1 = lerp7by8(grad8(P(AA), xx, yy), grad8(P(BA), xx - N, yy), u);
+    int8_t X2 = lerp7by8(grad8(P(AB), xx, yy - N), grad8(P(BB), xx - N, yy - N), u);
+
+    return lerp7by8(X1, X2, v);
+}
+
+uint8_t inoise8(uint16_t x, uint16_t y)
+{
+    int8_t n = inoise8_raw(x, y);
+    n += 64;
+    return qadd8(n, n);
+}
+
+uint8_t inoise8(uint16_t x)
+{
+    return inoise8(x, 0);
+}
+
+CLEDController::CLEDController(CRGB *leds, int numLeds, EOrder order)
+: mLeds(leds), mNumLeds(numLeds), mOrder(order), mWireData(numLeds * 3)
+{
+}
+
+CLEDController &CLEDController::setLeds(CRGB *leds, int numLeds)
+{
+    mLeds = leds;
+    mNumLeds = numLeds;
+    mWireData.resize(numLeds * 3);
+    return *this;
+}
+
+void CLEDController::show(uint8_t brightness)
+{
+    CRGB adj(scale8(mCorrection.r, brightness), scale8(mCorrection.g, brightness), scale8(mCorrection.b, brightness));
+
+    uint8_t c0 = (mOrder >> 6) & 0x3;
+    uint8_t c1 = (mOrder >> 3) & 0x7;
+    uint8_t c2 = mOrder & 0x7;
+
+    uint8_t *out = mWireData.data();
+    for (int i = 0; i < mNumLeds; i++) {
+        const CRGB &pixel = mLeds[i];
+        *out++ = scale8(pixel.raw[c0], adj.raw[c0]);
+        *out++ = scale8(pixel.raw[c1], adj.raw[c1]);
+        *out++ = scale8(pixel.raw[c2], adj.raw[c2]);
+    }
+}
+
+CLEDController &CFastLED::addController(CRGB *leds, int numLeds, EOrder order)
+{
+    CLEDController *controller = new CLEDController(leds, numLeds, order);
+    mControllers.push_back(controller);
+    return *controller;
+}
+
+void CFastLED::show(uint8_t scale)
+{
+    for (CLEDController *controller : mControllers) {
+        controller->show(scale);
+    }
+    mShowCount++;
+}
+
+void CFastLED::clear(bool writeData)
+{
+    for (CLEDController *controller : mControllers) {
+        fill_solid(controller->leds(), controller->size(), CRGB::Black);
+    }
+    if (writeData) {
+        show(0);
+    }
+}
+
+namespace native {
+
+    uint32_t ledShowCount()
+    {
+        return FastLED.showCount();
+    }
+
+    const uint8_t *ledWireData(int controller, size_t &length)
+    {
+        if (controller >= FastLED.count()) {
+            length = 0;
+            return nullptr;
+        }
+        const std::vector<uint8_t> &data = FastLED[controller].wireData();
+        length = data.size();
+        return data.data();
+    }
+
+}
@@ -0,0 +1,225 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host replacement for the subset of FastLED used by the controller.
+ * show() performs the per-pixel output processing (brightness, correction, color order)
+ * into a wire buffer instead of clocking data out.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <vector>
+
+#include <Arduino.h>
+
+#include "lib8tion.h"
+#include "chsv.h"
+#include "crgb.h"
+
+/* Color utilities */
+
+typedef uint32_t TProgmemRGBPalette16[16];
+
+enum TBlendType {
+    NOBLEND = 0,
+    LINEARBLEND = 1
+};
+
+class CRGBPalette16
+{
+    public:
+        CRGB entries[16];
+
+        CRGBPalette16() {}
+
+        CRGBPalette16(const TProgmemRGBPalette16 &rhs)
+        {
+            for (int i = 0; i < 16; i++) {
+                entries[i] = rhs[i];
+            }
+        }
+
+        CRGBPalette16 &operator=(const TProgmemRGBPalette16 &rhs)
+        {
+            for (int i = 0; i < 16; i++) {
+                entries[i] = rhs[i];
+            }
+            return *this;
+        }
+
+        CRGB &operator[](uint8_t x) { return entries[x]; }
+
+        const CRGB &operator[](uint8_t x) const { return entries[x]; }
+
+        bool operator==(const CRGBPalette16 &rhs) const
+        {
+            for (int i = 0; i < 16; i++) {
+                if (entries[i] != rhs.entries[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool operator!=(const CRGBPalette16 &rhs) const { return !(*this == rhs); }
+};
+
+extern const TProgmemRGBPalette16 CloudColors_p;
+extern const TProgmemRGBPalette16 LavaColors_p;
+extern const TProgmemRGBPalette16 OceanColors_p;
+extern const TProgmemRGBPalette16 ForestColors_p;
+extern const TProgmemRGBPalette16 RainbowColors_p;
+extern const TProgmemRGBPalette16 PartyColors_p;
+extern const TProgmemRGBPalette16 HeatColors_p;
+
+CRGB ColorFromPalette(const CRGBPalette16 &pal, uint8_t index, uint8_t brightness = 255,
+                      TBlendType blendType = LINEARBLEND);
+
+CHSV rgb2hsv_approximate(const CRGB &rgb);
+
+void fill_solid(CRGB *leds, int numToFill, const CRGB &color);
+
+void fill_rainbow(CRGB *leds, int numToFill, uint8_t initialhue, uint8_t deltahue = 5);
+
+void fadeToBlackBy(CRGB *leds, uint16_t numLeds, uint8_t fadeBy);
+
+void nscale8(CRGB *leds, uint16_t numLeds, uint8_t scale);
+
+CRGB blend(const CRGB &p1, const CRGB &p2, uint8_t amountOfP2);
+
+CRGB HeatColor(uint8_t temperature);
+
+uint8_t inoise8(uint16_t x, uint16_t y);
+
+uint8_t inoise8(uint16_t x);
+
+/* LED controllers */
+
+enum EOrder {
+    RGB = 0012,
+    RBG = 0021,
+    GRB = 0102,
+    GBR = 0120,
+    BRG = 0201,
+    BGR = 0210
+};
+
+enum LEDColorCorrection : uint32_t {
+    TypicalSMD5050 = 0xFFB0F0,
+    TypicalLEDStrip = 0xFFB0F0,
+    UncorrectedColor = 0xFFFFFF
+};
+
+static const uint8_t DISABLE_DITHER = 0x00;
+static const uint8_t BINARY_DITHER = 0x01;
+
+template<uint8_t DATA_PIN, EOrder RGB_ORDER> class WS2811 {};
+template<uint8_t DATA_PIN, EOrder RGB_ORDER> class WS2812B {};
+template<uint8_t DATA_PIN, EOrder RGB_ORDER> class WS2815 {};
+
+class CLEDController
+{
+    private:
+        CRGB *mLeds;
+        int mNumLeds;
+        EOrder mOrder;
+        CRGB mCorrection = CRGB(0xFFFFFF);
+
+        std::vector<uint8_t> mWireData;
+
+    public:
+        CLEDController(CRGB *leds, int numLeds, EOrder order);
+
+        CLEDController &setCorrection(LEDColorCorrection correction) { mCorrection = CRGB((uint32_t) correction); return *this; }
+
+        CLEDController &setCorrection(CRGB correction) { mCorrection = correction; return *this; }
+
+        CLEDController &setLeds(CRGB *leds, int numLeds);
+
+        CRGB *leds() { return mLeds; }
+
+        int size() const { return mNumLeds; }
+
+        void show(uint8_t brightness);
+
+        const std::vector<uint8_t> &wireData() const { return mWireData; }
+};
+
+class CFastLED
+{
+    private:
+        std::vector<CLEDController*> mControllers;
+        uint8_t mBrightness = 255;
+        uint8_t mDither = BINARY_DITHER;
+        uint32_t mShowCount = 0;
+
+        CLEDController &addController(CRGB *leds, int numLeds, EOrder order);
+
+    public:
+        template<template<uint8_t DATA_PIN, EOrder RGB_ORDER> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+        CLEDController &addLeds(CRGB *leds, int nLedsOrOffset, int nLedsIfOffset = 0)
+        {
+            if (nLedsIfOffset > 0) {
+                return addController(leds + nLedsOrOffset, nLedsIfOffset, RGB_ORDER);
+            }
+            return addController(leds, nLedsOrOffset, RGB_ORDER);
+        }
+
+        void setBrightness(uint8_t scale) { mBrightness = scale; }
+
+        uint8_t getBrightness() const { return mBrightness; }
+
+        void setDither(uint8_t ditherMode) { mDither = ditherMode; }
+
+        void show() { show(mBrightness); }
+
+        void show(uint8_t scale);
+
+        void clear(bool writeData = false);
+
+        int count() const { return mControllers.size(); }
+
+        CLEDController &operator[](int x) { return *mControllers[x]; }
+
+        uint32_t showCount() const { return mShowCount; }
+};
+
+extern CFastLED FastLED;
+
+/* Timers */
+
+class CEveryNMillis
+{
+    private:
+        uint32_t mPrevTrigger;
+        uint32_t mPeriod;
+
+    public:
+        explicit CEveryNMillis(uint32_t period) : mPrevTrigger(millis()), mPeriod(period) {}
+
+        bool ready()
+        {
+            uint32_t now = millis();
+            if (now - mPrevTrigger >= mPeriod) {
+                mPrevTrigger = now;
+                return true;
+            }
+            return false;
+        }
+
+        explicit operator bool() { return ready(); }
+};
+
+#define FASTLED_CONCAT_(a, b) a##b
+#define FASTLED_CONCAT(a, b) FASTLED_CONCAT_(a, b)
+
+#define EVERY_N_MILLISECONDS(N) static CEveryNMillis FASTLED_CONCAT(everyNMillis, __LINE__)(N); \
+                                if (FASTLED_CONCAT(everyNMillis, __LINE__))
+#define EVERY_N_MILLIS(N) EVERY_N_MILLISECONDS(N)
+#define EVERY_N_SECONDS(N) EVERY_N_MILLISECONDS((N) * 1000)
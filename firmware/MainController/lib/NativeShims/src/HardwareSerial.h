@@ -0,0 +1,109 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host replacement for the Arduino serial ports.
+ * Output goes to stdout unless muted, input is injected by the host program.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#include <deque>
+
+#include "WString.h"
+
+static const uint32_t SERIAL_8N1 = 0x800001c;
+
+class Print
+{
+    public:
+        virtual ~Print() {}
+
+        virtual size_t write(uint8_t c) = 0;
+
+        virtual size_t write(const uint8_t *buffer, size_t size);
+
+        size_t write(const char *str);
+
+        size_t print(const char *str);
+
+        size_t print(const String &str) { return print(str.c_str()); }
+
+        size_t print(char c) { return write((uint8_t) c); }
+
+        size_t print(int value, int base = DEC);
+
+        size_t print(unsigned int value, int base = DEC);
+
+        size_t print(long value, int base = DEC);
+
+        size_t print(unsigned long value, int base = DEC);
+
+        size_t print(double value, int digits = 2);
+
+        size_t println() { return write('\n'); }
+
+        template<typename T>
+        size_t println(const T &value) { size_t n = print(value); return n + println(); }
+
+        size_t printf(const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+
+        virtual void flush() {}
+};
+
+class HardwareSerial : public Print
+{
+    private:
+        int mPort;
+
+        std::deque<uint8_t> mRxBuffer;
+
+        uint32_t mBaudRate = 0;
+
+    public:
+        explicit HardwareSerial(int port) : mPort(port) {}
+
+        void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+
+        void updateBaudRate(unsigned long baud) { mBaudRate = baud; }
+
+        size_t setRxBufferSize(size_t size) { return size; }
+
+        uint32_t baudRate() const { return mBaudRate; }
+
+        void end() {}
+
+        int available() { return mRxBuffer.size(); }
+
+        int read();
+
+        /**
+         * Read up to size bytes which are already available, without waiting.
+         */
+        size_t read(uint8_t *buffer, size_t size) { return readBytes(buffer, size); }
+
+        size_t readBytes(uint8_t *buffer, size_t length);
+
+        int peek() { return mRxBuffer.empty() ? -1 : mRxBuffer.front(); }
+
+        using Print::write;
+
+        virtual size_t write(uint8_t c);
+
+        virtual size_t write(const uint8_t *buffer, size_t size);
+
+        /**
+         * Host only: queue bytes to be returned by read().
+         */
+        void inject(const uint8_t *data, size_t length);
+
+        void inject(const char *str);
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,34 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host replacement for the Arduino IPAddress class.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include "WString.h"
+
+class IPAddress
+{
+    private:
+        uint8_t mAddress[4];
+
+    public:
+        IPAddress() : mAddress{0, 0, 0, 0} {}
+
+        IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : mAddress{a, b, c, d} {}
+
+        uint8_t operator[](int index) const { return mAddress[index]; }
+
+        bool operator==(const IPAddress &rhs) const;
+
+        String toString() const;
+};
+
+extern const IPAddress INADDR_NONE;
@@ -0,0 +1,59 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host-only controls for the native shims (simulated clock, pin and LED output inspection).
+ * Never include this from firmware sources.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+#include <stddef.h>
+
+namespace native {
+
+    /**
+     * Set the simulated time returned by millis() and micros(), in microseconds.
+     */
+    void setMicros(uint64_t us);
+
+    void advanceMicros(uint64_t us);
+
+    void advanceMillis(uint32_t ms);
+
+    uint64_t currentMicros();
+
+    /**
+     * Monotonic wall-clock time in nanoseconds, for measurements.
+     */
+    uint64_t wallNanos();
+
+    int pinValue(uint8_t pin);
+
+    int analogValue(uint8_t pin);
+
+    /**
+     * Suppress all output written to Serial.
+     */
+    void muteSerial(bool mute);
+
+    /**
+     * Report the WiFi station as connected, so that network services are started.
+     */
+    void setWiFiConnected(bool connected);
+
+    /**
+     * Number of FastLED.show() calls since start.
+     */
+    uint32_t ledShowCount();
+
+    /**
+     * Wire bytes of the last frame sent by the given controller, after brightness, correction and color order.
+     */
+    const uint8_t *ledWireData(int controller, size_t &length);
+
+}
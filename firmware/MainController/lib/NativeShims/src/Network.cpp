@@ -0,0 +1,87 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host implementation of the WiFi, MQTT and Preferences shims.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include <Arduino.h>
+#include <WiFi.h>
+#include <PubSubClient.h>
+#include <Preferences.h>
+
+#include <vector>
+
+#include "NativeHost.h"
+
+WiFiClass WiFi;
+
+void native::setWiFiConnected(bool connected)
+{
+    WiFi.setConnected(connected);
+}
+
+void PubSubClient::inject(const char *topic, const char *payload)
+{
+    if (!callback) {
+        return;
+    }
+    std::vector<char> t(topic, topic + strlen(topic) + 1);
+    std::vector<uint8_t> p(payload, payload + strlen(payload) + 1);
+    callback(t.data(), p.data(), strlen(payload));
+}
+
+size_t Preferences::getValue(const char *key, void *value, size_t length)
+{
+    auto it = mValues.find(key);
+    if (it == mValues.end() || it->second.size() > length) {
+        return 0;
+    }
+    memcpy(value, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t Preferences::putValue(const char *key, const void *value, size_t length)
+{
+    const uint8_t *data = (const uint8_t*) value;
+    mValues[key].assign(data, data + length);
+    return length;
+}
+
+uint8_t Preferences::getUChar(const char *key, uint8_t defaultValue)
+{
+    uint8_t value = defaultValue;
+    getValue(key, &value, sizeof(value));
+    return value;
+}
+
+uint16_t Preferences::getUShort(const char *key, uint16_t defaultValue)
+{
+    uint16_t value = defaultValue;
+    getValue(key, &value, sizeof(value));
+    return value;
+}
+
+uint32_t Preferences::getUInt(const char *key, uint32_t defaultValue)
+{
+    uint32_t value = defaultValue;
+    getValue(key, &value, sizeof(value));
+    return value;
+}
+
+String Preferences::getString(const char *key, const String defaultValue)
+{
+    auto it = mValues.find(key);
+    if (it == mValues.end()) {
+        return defaultValue;
+    }
+    return String((const char*) it->second.data(), it->second.size());
+}
+
+size_t Preferences::putString(const char *key, const char *value)
+{
+    return putValue(key, value, strlen(value));
+}
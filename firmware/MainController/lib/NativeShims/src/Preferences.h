@@ -0,0 +1,58 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host replacement for the ESP32 Preferences (NVS) library, kept in memory.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+class Preferences
+{
+    private:
+        std::map<std::string, std::vector<uint8_t>> mValues;
+
+        size_t getValue(const char *key, void *value, size_t length);
+
+        size_t putValue(const char *key, const void *value, size_t length);
+
+    public:
+        bool begin(const char *name, bool readOnly = false) { return true; }
+
+        void end() {}
+
+        bool clear() { mValues.clear(); return true; }
+
+        bool isKey(const char *key) { return mValues.count(key) > 0; }
+
+        uint8_t getUChar(const char *key, uint8_t defaultValue = 0);
+
+        size_t putUChar(const char *key, uint8_t value) { return putValue(key, &value, sizeof(value)); }
+
+        uint16_t getUShort(const char *key, uint16_t defaultValue = 0);
+
+        size_t putUShort(const char *key, uint16_t value) { return putValue(key, &value, sizeof(value)); }
+
+        uint32_t getUInt(const char *key, uint32_t defaultValue = 0);
+
+        size_t putUInt(const char *key, uint32_t value) { return putValue(key, &value, sizeof(value)); }
+
+        String getString(const char *key, const String defaultValue = String());
+
+        size_t putString(const char *key, const char *value);
+
+        size_t putString(const char *key, const String &value) { return putString(key, value.c_str()); }
+
+        size_t getBytes(const char *key, void *buf, size_t maxLen) { return getValue(key, buf, maxLen); }
+
+        size_t putBytes(const char *key, const void *value, size_t length) { return putValue(key, value, length); }
+};
@@ -0,0 +1,59 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host replacement for the PubSubClient MQTT library.
+ * Publishes are counted, incoming messages can be injected by the host program.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#include <functional>
+
+#define MQTT_CALLBACK_SIGNATURE std::function<void(char*, uint8_t*, unsigned int)> callback
+
+class PubSubClient
+{
+    private:
+        MQTT_CALLBACK_SIGNATURE;
+
+        bool mConnected = false;
+
+        uint32_t mPublishCount = 0;
+
+    public:
+        explicit PubSubClient(WiFiClient &client) {}
+
+        PubSubClient &setServer(IPAddress ip, uint16_t port) { return *this; }
+
+        PubSubClient &setServer(const char *domain, uint16_t port) { return *this; }
+
+        PubSubClient &setCallback(MQTT_CALLBACK_SIGNATURE) { this->callback = callback; return *this; }
+
+        bool connect(const char *id, const char *user, const char *pass) { mConnected = true; return true; }
+
+        void disconnect() { mConnected = false; }
+
+        bool connected() { return mConnected; }
+
+        int state() { return mConnected ? 0 : -1; }
+
+        bool publish(const char *topic, const char *payload, bool retained) { mPublishCount++; return mConnected; }
+
+        bool subscribe(const char *topic) { return mConnected; }
+
+        bool loop() { return mConnected; }
+
+        /**
+         * Host only: deliver a message to the registered callback.
+         */
+        void inject(const char *topic, const char *payload);
+
+        uint32_t publishCount() const { return mPublishCount; }
+};
@@ -0,0 +1,127 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host replacement for the Arduino String class.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "WString.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+void String::appendNumber(unsigned long long value, bool negative, int base)
+{
+    char buf[72];
+    int pos = sizeof(buf);
+
+    buf[--pos] = '\0';
+    do {
+        int digit = value % base;
+        buf[--pos] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    } while (value > 0);
+
+    if (negative) {
+        buf[--pos] = '-';
+    }
+    mStr += &buf[pos];
+}
+
+String::String(unsigned char value, int base)
+{
+    appendNumber(value, false, base);
+}
+
+String::String(int value, int base)
+{
+    if (base == DEC && value < 0) {
+        appendNumber(-(long long) value, true, base);
+    } else {
+        appendNumber((unsigned int) value, false, base);
+    }
+}
+
+String::String(unsigned int value, int base)
+{
+    appendNumber(value, false, base);
+}
+
+String::String(long value, int base)
+{
+    if (base == DEC && value < 0) {
+        appendNumber(-(long long) value, true, base);
+    } else {
+        appendNumber((unsigned long) value, false, base);
+    }
+}
+
+String::String(unsigned long value, int base)
+{
+    appendNumber(value, false, base);
+}
+
+String::String(float value, unsigned int decimalPlaces)
+{
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+    mStr = buf;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+    if (suffix.mStr.length() > mStr.length()) {
+        return false;
+    }
+    return mStr.compare(mStr.length() - suffix.mStr.length(), suffix.mStr.length(), suffix.mStr) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+    size_t pos = mStr.find(c, from);
+    return pos == std::string::npos ? -1 : (int) pos;
+}
+
+String String::substring(unsigned int from) const
+{
+    if (from >= mStr.length()) {
+        return String();
+    }
+    return String(mStr.substr(from));
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+    if (from > to) {
+        unsigned int tmp = from;
+        from = to;
+        to = tmp;
+    }
+    if (from >= mStr.length()) {
+        return String();
+    }
+    return String(mStr.substr(from, to - from));
+}
+
+void String::toLowerCase()
+{
+    for (char &c : mStr) {
+        c = tolower(c);
+    }
+}
+
+void String::toUpperCase()
+{
+    for (char &c : mStr) {
+        c = toupper(c);
+    }
+}
+
+long String::toInt() const
+{
+    return strtol(mStr.c_str(), nullptr, 10);
+}
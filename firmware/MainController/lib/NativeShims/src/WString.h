@@ -0,0 +1,100 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host replacement for the Arduino String class.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+#include <string>
+
+static const int DEC = 10;
+static const int HEX = 16;
+static const int OCT = 8;
+static const int BIN = 2;
+
+class String
+{
+    private:
+        std::string mStr;
+
+        void appendNumber(unsigned long long value, bool negative, int base);
+
+    public:
+        String() {}
+
+        String(const char *str) : mStr(str ? str : "") {}
+
+        String(const char *str, unsigned int length) : mStr(str, length) {}
+
+        String(const uint8_t *str, unsigned int length) : mStr((const char*) str, length) {}
+
+        String(const std::string &str) : mStr(str) {}
+
+        explicit String(char c) : mStr(1, c) {}
+
+        explicit String(unsigned char value, int base = DEC);
+
+        explicit String(int value, int base = DEC);
+
+        explicit String(unsigned int value, int base = DEC);
+
+        explicit String(long value, int base = DEC);
+
+        explicit String(unsigned long value, int base = DEC);
+
+        explicit String(float value, unsigned int decimalPlaces = 2);
+
+        const char *c_str() const { return mStr.c_str(); }
+
+        unsigned int length() const { return mStr.length(); }
+
+        bool concat(const char *str) { mStr += str; return true; }
+
+        bool concat(const char *str, unsigned int length) { mStr.append(str, length); return true; }
+
+        bool concat(char c) { mStr += c; return true; }
+
+        bool concat(const String &str) { mStr += str.mStr; return true; }
+
+        bool startsWith(const String &prefix) const { return mStr.compare(0, prefix.mStr.length(), prefix.mStr) == 0; }
+
+        bool endsWith(const String &suffix) const;
+
+        int indexOf(char c, unsigned int from = 0) const;
+
+        String substring(unsigned int from) const;
+
+        String substring(unsigned int from, unsigned int to) const;
+
+        void toLowerCase();
+
+        void toUpperCase();
+
+        long toInt() const;
+
+        char operator[](unsigned int index) const { return index < mStr.length() ? mStr[index] : 0; }
+
+        String &operator+=(const String &rhs) { mStr += rhs.mStr; return *this; }
+
+        String &operator+=(const char *rhs) { mStr += rhs; return *this; }
+
+        String &operator+=(char rhs) { mStr += rhs; return *this; }
+
+        bool operator==(const String &rhs) const { return mStr == rhs.mStr; }
+
+        bool operator==(const char *rhs) const { return mStr == rhs; }
+
+        bool operator!=(const String &rhs) const { return mStr != rhs.mStr; }
+
+        bool operator!=(const char *rhs) const { return mStr != rhs; }
+
+        friend String operator+(const String &lhs, const String &rhs) { return String(lhs.mStr + rhs.mStr); }
+
+        friend String operator+(const String &lhs, const char *rhs) { return String(lhs.mStr + rhs); }
+};
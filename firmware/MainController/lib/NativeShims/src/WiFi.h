@@ -0,0 +1,73 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host replacement for the ESP32 WiFi library. The station is disconnected unless
+ * a benchmark sets it connected with native::setWiFiConnected().
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <Arduino.h>
+
+enum wl_status_t {
+    WL_IDLE_STATUS     = 0,
+    WL_NO_SSID_AVAIL   = 1,
+    WL_CONNECTED       = 3,
+    WL_CONNECT_FAILED  = 4,
+    WL_DISCONNECTED    = 6
+};
+
+enum wifi_mode_t {
+    WIFI_OFF  = 0,
+    WIFI_STA  = 1,
+    WIFI_AP   = 2
+};
+
+class WiFiClient
+{
+    public:
+        WiFiClient() {}
+};
+
+class WiFiClass
+{
+    private:
+        String mHostname = "native";
+
+        bool   mConnected = false;
+
+    public:
+        void setConnected(bool connected) { mConnected = connected; }
+
+        wl_status_t status() { return mConnected ? WL_CONNECTED : WL_DISCONNECTED; }
+
+        bool isConnected() { return mConnected; }
+
+        bool mode(wifi_mode_t mode) { return true; }
+
+        bool config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns) { return true; }
+
+        bool setHostname(const char *hostname) { mHostname = hostname; return true; }
+
+        const char *getHostname() { return mHostname.c_str(); }
+
+        wl_status_t begin(const String &ssid, const String &password) { return WL_DISCONNECTED; }
+
+        wl_status_t begin(const char *ssid, const char *password) { return WL_DISCONNECTED; }
+
+        bool disconnect() { return true; }
+
+        bool reconnect() { return false; }
+
+        int hostByName(const char *host, IPAddress &result) { result = IPAddress(127, 0, 0, 1); return 1; }
+
+        IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+
+        IPAddress dnsIP() { return IPAddress(); }
+};
+
+extern WiFiClass WiFi;
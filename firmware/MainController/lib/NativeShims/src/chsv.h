@@ -0,0 +1,51 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host replacement for the FastLED CHSV type.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+struct CHSV {
+    union {
+        struct {
+            union {
+                uint8_t hue;
+                uint8_t h;
+            };
+            union {
+                uint8_t saturation;
+                uint8_t sat;
+                uint8_t s;
+            };
+            union {
+                uint8_t value;
+                uint8_t val;
+                uint8_t v;
+            };
+        };
+        uint8_t raw[3];
+    };
+
+    CHSV() : hue(0), sat(0), val(0) {}
+
+    CHSV(uint8_t ih, uint8_t is, uint8_t iv) : hue(ih), sat(is), val(iv) {}
+
+    uint8_t &operator[](uint8_t x) { return raw[x]; }
+
+    const uint8_t &operator[](uint8_t x) const { return raw[x]; }
+
+    CHSV &setHSV(uint8_t ih, uint8_t is, uint8_t iv)
+    {
+        hue = ih;
+        sat = is;
+        val = iv;
+        return *this;
+    }
+};
@@ -0,0 +1,147 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host replacement for the FastLED CRGB type.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include "chsv.h"
+#include "lib8tion.h"
+
+struct CRGB;
+
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb);
+
+struct CRGB {
+    union {
+        struct {
+            union {
+                uint8_t r;
+                uint8_t red;
+            };
+            union {
+                uint8_t g;
+                uint8_t green;
+            };
+            union {
+                uint8_t b;
+                uint8_t blue;
+            };
+        };
+        uint8_t raw[3];
+    };
+
+    enum HTMLColorCode : uint32_t {
+        Aqua           = 0x00FFFF,
+        Aquamarine     = 0x7FFFD4,
+        Black          = 0x000000,
+        Blue           = 0x0000FF,
+        CadetBlue      = 0x5F9EA0,
+        CornflowerBlue = 0x6495ED,
+        DarkBlue       = 0x00008B,
+        DarkCyan       = 0x008B8B,
+        Green          = 0x008000,
+        LightSkyBlue   = 0x87CEFA,
+        MediumBlue     = 0x0000CD,
+        MidnightBlue   = 0x191970,
+        Navy           = 0x000080,
+        Red            = 0xFF0000,
+        SeaGreen       = 0x2E8B57,
+        Teal           = 0x008080,
+        White          = 0xFFFFFF
+    };
+
+    CRGB() : r(0), g(0), b(0) {}
+
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+
+    CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+
+    CRGB(HTMLColorCode colorcode) : CRGB((uint32_t) colorcode) {}
+
+    CRGB(const CHSV &rhs) { hsv2rgb_rainbow(rhs, *this); }
+
+    CRGB &operator=(const CHSV &rhs) { hsv2rgb_rainbow(rhs, *this); return *this; }
+
+    CRGB &operator=(uint32_t colorcode)
+    {
+        r = (colorcode >> 16) & 0xFF;
+        g = (colorcode >> 8) & 0xFF;
+        b = colorcode & 0xFF;
+        return *this;
+    }
+
+    uint8_t &operator[](uint8_t x) { return raw[x]; }
+
+    const uint8_t &operator[](uint8_t x) const { return raw[x]; }
+
+    CRGB &setRGB(uint8_t nr, uint8_t ng, uint8_t nb)
+    {
+        r = nr;
+        g = ng;
+        b = nb;
+        return *this;
+    }
+
+    CRGB &operator+=(const CRGB &rhs)
+    {
+        r = qadd8(r, rhs.r);
+        g = qadd8(g, rhs.g);
+        b = qadd8(b, rhs.b);
+        return *this;
+    }
+
+    CRGB &operator-=(const CRGB &rhs)
+    {
+        r = qsub8(r, rhs.r);
+        g = qsub8(g, rhs.g);
+        b = qsub8(b, rhs.b);
+        return *this;
+    }
+
+    CRGB &operator|=(const CRGB &rhs)
+    {
+        if (rhs.r > r) r = rhs.r;
+        if (rhs.g > g) g = rhs.g;
+        if (rhs.b > b) b = rhs.b;
+        return *this;
+    }
+
+    CRGB &nscale8(uint8_t scaledown)
+    {
+        r = scale8(r, scaledown);
+        g = scale8(g, scaledown);
+        b = scale8(b, scaledown);
+        return *this;
+    }
+
+    CRGB &nscale8_video(uint8_t scaledown)
+    {
+        r = scale8_video(r, scaledown);
+        g = scale8_video(g, scaledown);
+        b = scale8_video(b, scaledown);
+        return *this;
+    }
+
+    CRGB &fadeToBlackBy(uint8_t fadefactor) { return nscale8(255 - fadefactor); }
+
+    uint8_t getAverageLight() const { return (scale8(r, 85) + scale8(g, 85) + scale8(b, 85)); }
+
+    explicit operator bool() const { return r || g || b; }
+
+    bool operator==(const CRGB &rhs) const { return r == rhs.r && g == rhs.g && b == rhs.b; }
+
+    bool operator!=(const CRGB &rhs) const { return !(*this == rhs); }
+};
+
+inline CRGB operator+(const CRGB &p1, const CRGB &p2)
+{
+    return CRGB(qadd8(p1.r, p2.r), qadd8(p1.g, p2.g), qadd8(p1.b, p2.b));
+}
@@ -0,0 +1,200 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Host replacement for the FastLED lib8tion math helpers.
+ * Uses the same fixed-point algorithms as the portable C versions in FastLED.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <Arduino.h>
+
+typedef uint16_t accum88;
+
+inline uint8_t scale8(uint8_t i, uint8_t scale)
+{
+    return ((uint16_t) i * (1 + (uint16_t) scale)) >> 8;
+}
+
+inline uint8_t scale8_video(uint8_t i, uint8_t scale)
+{
+    return (((uint16_t) i * (uint16_t) scale) >> 8) + ((i && scale) ? 1 : 0);
+}
+
+inline uint8_t dim8_video(uint8_t x)
+{
+    return scale8_video(x, x);
+}
+
+inline uint16_t scale16(uint16_t i, uint16_t scale)
+{
+    return ((uint32_t) i * (1 + (uint32_t) scale)) >> 16;
+}
+
+inline uint16_t scale16by8(uint16_t i, uint8_t scale)
+{
+    return (i * (1 + (uint32_t) scale)) >> 8;
+}
+
+inline uint8_t qadd8(uint8_t i, uint8_t j)
+{
+    unsigned int t = i + j;
+    return t > 255 ? 255 : t;
+}
+
+inline uint8_t qsub8(uint8_t i, uint8_t j)
+{
+    int t = i - j;
+    return t < 0 ? 0 : t;
+}
+
+inline uint8_t qmul8(uint8_t i, uint8_t j)
+{
+    unsigned int p = (unsigned int) i * j;
+    return p > 255 ? 255 : p;
+}
+
+inline uint8_t lerp8by8(uint8_t a, uint8_t b, uint8_t frac)
+{
+    if (b > a) {
+        return a + scale8(b - a, frac);
+    }
+    return a - scale8(a - b, frac);
+}
+
+inline uint8_t triwave8(uint8_t in)
+{
+    if (in & 0x80) {
+        in = 255 - in;
+    }
+    return in << 1;
+}
+
+inline uint8_t ease8InOutQuad(uint8_t i)
+{
+    uint8_t j = i;
+    if (j & 0x80) {
+        j = 255 - j;
+    }
+    uint8_t jj = scale8(j, j);
+    uint8_t jj2 = jj << 1;
+    if (i & 0x80) {
+        jj2 = 255 - jj2;
+    }
+    return jj2;
+}
+
+inline uint8_t ease8InOutCubic(uint8_t i)
+{
+    uint8_t ii = scale8(i, i);
+    uint8_t iii = scale8(ii, i);
+    uint16_t r1 = (3 * (uint16_t) ii) - (2 * (uint16_t) iii);
+    // Clamp 256 to 255
+    return (r1 & 0x100) ? 255 : r1;
+}
+
+inline uint8_t cubicwave8(uint8_t in)
+{
+    return ease8InOutQuad(triwave8(in));
+}
+
+int16_t sin16(uint16_t theta);
+
+inline int16_t cos16(uint16_t theta)
+{
+    return sin16(theta + 16384);
+}
+
+uint8_t sin8(uint8_t theta);
+
+inline uint8_t cos8(uint8_t theta)
+{
+    return sin8(theta + 64);
+}
+
+/* Pseudo random numbers, same LCG as FastLED */
+
+extern uint16_t rand16seed;
+
+inline uint8_t random8()
+{
+    rand16seed = (rand16seed * 2053) + 13849;
+    return (uint8_t) (((uint8_t) (rand16seed & 0xFF)) + ((uint8_t) (rand16seed >> 8)));
+}
+
+inline uint8_t random8(uint8_t lim)
+{
+    return (random8() * lim) >> 8;
+}
+
+inline uint8_t random8(uint8_t min, uint8_t lim)
+{
+    return random8(lim - min) + min;
+}
+
+inline uint16_t random16()
+{
+    rand16seed = (rand16seed * 2053) + 13849;
+    return rand16seed;
+}
+
+inline uint16_t random16(uint16_t lim)
+{
+    return ((uint32_t) random16() * lim) >> 16;
+}
+
+inline uint16_t random16(uint16_t min, uint16_t lim)
+{
+    return random16(lim - min) + min;
+}
+
+inline void random16_add_entropy(uint16_t entropy)
+{
+    rand16seed += entropy;
+}
+
+/* Beat generators, based on millis() */
+
+inline uint16_t beat88(accum88 beats_per_minute_88, uint32_t timebase = 0)
+{
+    return (((millis()) - timebase) * beats_per_minute_88 * 280) >> 16;
+}
+
+inline uint16_t beat16(accum88 beats_per_minute, uint32_t timebase = 0)
+{
+    if (beats_per_minute < 256) {
+        beats_per_minute <<= 8;
+    }
+    return beat88(beats_per_minute, timebase);
+}
+
+inline uint8_t beat8(accum88 beats_per_minute, uint32_t timebase = 0)
+{
+    return beat16(beats_per_minute, timebase) >> 8;
+}
+
+inline uint16_t beatsin16(accum88 beats_per_minute, uint16_t lowest = 0, uint16_t highest = 65535,
+                          uint32_t timebase = 0, uint16_t phase_offset = 0)
+{
+    uint16_t beat = beat16(beats_per_minute, timebase);
+    uint16_t beatsin = (sin16(beat + phase_offset) + 32768);
+    uint16_t rangewidth = highest - lowest;
+    uint16_t scaledbeat = scale16(beatsin, rangewidth);
+    return lowest + scaledbeat;
+}
+
+inline uint8_t beatsin8(accum88 beats_per_minute, uint8_t lowest = 0, uint8_t highest = 255,
+                        uint32_t timebase = 0, uint8_t phase_offset = 0)
+{
+    uint8_t beat = beat8(beats_per_minute, timebase);
+    uint8_t beatsin = sin8(beat + phase_offset);
+    uint8_t rangewidth = highest - lowest;
+    uint8_t scaledbeat = scale8(beatsin, rangewidth);
+    return lowest + scaledbeat;
+}
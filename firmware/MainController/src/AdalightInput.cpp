@@ -0,0 +1,145 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Adalight-style serial frame input implementation.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "AdalightInput.h"
+
+#include <Arduino.h>
+
+#include <string.h>
+
+#include "config.h"
+
+static const uint8_t ADA_MAGIC[3] = { 'A', 'd', 'a' };
+static const uint8_t ADA_HEADER_LENGTH = 6;
+static const uint8_t ADA_CHECKSUM_KEY = 0x55;
+
+static const char *ADA_ACK = "Ada\n";
+
+static const uint32_t FRAME_BYTES = (uint32_t) NUM_LEDS * 3;
+
+
+AdalightInput::AdalightInput(LEDDriver &leds)
+: mLEDs(leds)
+{
+}
+
+CmdParseStatus AdalightInput::parseHeader(const uint8_t *header, int length)
+{
+    for (int i = 0; i < length && i < (int) sizeof(ADA_MAGIC); i++) {
+        if (header[i] != ADA_MAGIC[i]) {
+            return CmdParseStatus::CPSInvalidArgument;
+        }
+    }
+    if (length < ADA_HEADER_LENGTH) {
+        return CmdParseStatus::CPSNextArgument;
+    }
+
+    uint8_t hi = header[3];
+    uint8_t lo = header[4];
+    if (header[5] != (hi ^ lo ^ ADA_CHECKSUM_KEY)) {
+        return CmdParseStatus::CPSInvalidArgument;
+    }
+
+    // Up to 65536 pixels, more than the frame buffer holds
+    uint32_t numPixels = (((uint32_t) hi << 8) | lo) + 1;
+    if (numPixels > NUM_LEDS) {
+        return CmdParseStatus::CPSInvalidArgument;
+    }
+    mLastData = millis();
+
+    startFrame(numPixels);
+    return CmdParseStatus::CPSComplete;
+}
+
+void AdalightInput::startFrame(uint32_t numPixels)
+{
+    mFrame = mLEDs.streamFrameBuffer();
+    mFrameBytes = (uint32_t) numPixels * 3;
+    mReceived = 0;
+    mReadingPixels = true;
+}
+
+void AdalightInput::completeFrame()
+{
+    if (mFrameBytes < FRAME_BYTES) {
+        // Sender drives a shorter strip
+        memset((uint8_t*) mFrame + mFrameBytes, 0, FRAME_BYTES - mFrameBytes);
+    }
+    mLEDs.publishStreamFrame();
+    mFrameCount++;
+
+    mReadingPixels = false;
+    mHeaderLength = 0;
+
+    Serial.write((const uint8_t*) ADA_ACK, strlen(ADA_ACK));
+}
+
+void AdalightInput::readHeader(uint8_t c)
+{
+    mHeader[mHeaderLength++] = c;
+
+    CmdParseStatus ret = parseHeader(mHeader, mHeaderLength);
+
+    if (ret == CmdParseStatus::CPSInvalidArgument) {
+        // Resynchronize on the next magic
+        mHeaderLength = 0;
+        if (c == ADA_MAGIC[0]) {
+            mHeader[mHeaderLength++] = c;
+        }
+    }
+}
+
+void AdalightInput::endStream()
+{
+    mReadingPixels = false;
+    mHeaderLength = 0;
+
+    Serial.printf("[Ada] Serial stream ended after %u frames\n", mFrameCount);
+}
+
+bool AdalightInput::readStream()
+{
+    int available = Serial.available();
+
+    if (available <= 0) {
+        if (millis() - mLastData >= SERIAL_STREAM_TIMEOUT_MS) {
+            endStream();
+            return false;
+        }
+        return true;
+    }
+    mLastData = millis();
+
+    while (available > 0) {
+        if (!mReadingPixels) {
+            readHeader(Serial.read());
+            available--;
+            continue;
+        }
+
+        uint32_t length = mFrameBytes - mReceived;
+        if (length > (uint32_t) available) {
+            length = available;
+        }
+
+        // Read the pixels straight into the frame buffer
+        size_t n = Serial.read((uint8_t*) mFrame + mReceived, length);
+        if (n == 0) {
+            break;
+        }
+        mReceived += n;
+        available -= n;
+
+        if (mReceived == mFrameBytes) {
+            completeFrame();
+        }
+    }
+    return true;
+}
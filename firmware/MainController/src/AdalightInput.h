@@ -0,0 +1,65 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Adalight-style binary frame input over the USB console.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include "CommandLine.h"
+#include "LED.h"
+
+/**
+ * Streams RGB frames from the serial console into the LED strip.
+ *
+ * Every frame starts with the Adalight header 'A' 'd' 'a' <count-1 high> <count-1 low> <high ^ low ^ 0x55>,
+ * followed by count RGB pixels. Each frame is acknowledged with "Ada\n". The stream runs at the console
+ * baud rate SERIAL_CONSOLE_BAUD. Frames with more than NUM_LEDS pixels are rejected, the input then waits
+ * for the next header. The command line takes over again when no data has been received for
+ * SERIAL_STREAM_TIMEOUT_MS.
+ */
+class AdalightInput : public StreamParser
+{
+    private:
+        LEDDriver &mLEDs;
+
+        // Header of the next frame received so far
+        uint8_t   mHeader[6];
+        uint8_t   mHeaderLength = 0;
+        bool      mReadingPixels = false;
+
+        // Pixel data of the current frame
+        CRGB     *mFrame = nullptr;
+        uint32_t  mFrameBytes = 0;
+        uint32_t  mReceived = 0;
+
+        unsigned long mLastData = 0;
+
+        uint32_t  mFrameCount = 0;
+
+        void startFrame(uint32_t numPixels);
+
+        void completeFrame();
+
+        void readHeader(uint8_t c);
+
+        void endStream();
+
+    public:
+        explicit AdalightInput(LEDDriver &leds);
+
+        /**
+         * Number of frames received since start.
+         */
+        uint32_t frameCount() const { return mFrameCount; }
+
+        virtual CmdParseStatus parseHeader(const uint8_t *header, int length);
+
+        virtual bool readStream();
+};
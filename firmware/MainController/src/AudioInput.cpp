@@ -0,0 +1,54 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Audio spectrum input implementation.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "AudioInput.h"
+
+#include <string.h>
+
+static const uint8_t AUDIO_MAGIC[4] = { 'F', 'L', 'S', 'P' };
+
+static const uint8_t AUDIO_OFFSET_SEQUENCE = 4;
+static const uint8_t AUDIO_OFFSET_BANDS = 5;
+static const uint8_t AUDIO_PACKET_LENGTH = AUDIO_OFFSET_BANDS + AUDIO_NUM_BANDS;
+
+static_assert(AUDIO_PACKET_LENGTH <= PACKET_INPUT_MAX_LENGTH, "Spectrum packets must fit into the packet buffer");
+
+AudioInput::AudioInput()
+: PacketInput("Audio", "audio spectrum", AUDIO_SPECTRUM_PORT, AUDIO_MAGIC, AUDIO_PACKET_LENGTH)
+{
+}
+
+bool AudioInput::decode(const uint8_t *packet)
+{
+    // Gaps of up to half the sequence range are lost packets, anything else is a restarted sender
+    uint8_t gap = packet[AUDIO_OFFSET_SEQUENCE] - mSequence - 1;
+    if (mSequenceValid && gap < 128) {
+        mLostCount += gap;
+    }
+    mSequence = packet[AUDIO_OFFSET_SEQUENCE];
+    mSequenceValid = true;
+
+    const uint8_t *levels = packet + AUDIO_OFFSET_BANDS;
+    for (uint8_t b = 0; b < AUDIO_NUM_BANDS; b++) {
+        mBands[b] = mFirstInFrame || levels[b] > mBands[b] ? levels[b] : mBands[b];
+    }
+    mFirstInFrame = false;
+    return true;
+}
+
+bool AudioInput::receive(uint8_t *bands)
+{
+    mFirstInFrame = true;
+    if (!poll()) {
+        return false;
+    }
+    memcpy(bands, mBands, AUDIO_NUM_BANDS);
+    return true;
+}
@@ -0,0 +1,53 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Receives audio spectrum frames over UDP for the audio reactive effects.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include "config.h"
+#include "PacketInput.h"
+
+/**
+ * Audio spectrum input on AUDIO_SPECTRUM_PORT. Owned and polled by the render task.
+ */
+class AudioInput : public PacketInput
+{
+    private:
+        // Loudest level of each band since the last frame
+        uint8_t  mBands[AUDIO_NUM_BANDS];
+        bool     mFirstInFrame = true;
+
+        uint8_t  mSequence = 0;
+        bool     mSequenceValid = false;
+        uint32_t mLostCount = 0;
+
+    protected:
+        virtual bool decode(const uint8_t *packet);
+
+    public:
+        AudioInput();
+
+        /**
+         * Receive all pending packets.
+         *
+         * Senders may run faster than the frame rate, so the loudest level of every band over all packets
+         * received since the last frame is kept, instead of the latest one.
+         *
+         * @param bands: AUDIO_NUM_BANDS levels, set if at least one valid packet was received.
+         * @return true if a valid packet was received.
+         */
+        bool receive(uint8_t *bands);
+
+        /**
+         * Packets missing in the sequence numbers of the received packets.
+         */
+        uint32_t lostCount() const { return mLostCount; }
+};
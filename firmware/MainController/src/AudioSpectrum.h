@@ -0,0 +1,137 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Smoothed audio spectrum levels with peak hold for the audio reactive effects.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include "config.h"
+
+// Share of a level lost per millisecond, in 1/65536; about 1/150 gives a time constant of 150 ms
+static const uint16_t AUDIO_DECAY_RATE = 437;
+
+// Peaks stay at their level for this long, then fall at a constant speed
+static const uint16_t AUDIO_PEAK_HOLD_MS = 500;
+// Fall of the peaks, in levels per second
+static const uint16_t AUDIO_PEAK_FALL_SPEED = 320;
+
+// Lowest bands averaged into the bass level
+static const uint8_t AUDIO_BASS_BANDS = 3;
+
+/**
+ * A level which follows rises at once and decays exponentially, and a peak of it which holds and then falls.
+ *
+ * Both are kept in 8.8 fixed point, so that slow decays do not stall on rounding at low levels.
+ */
+class AudioLevel
+{
+    private:
+        uint16_t mLevel = 0;
+        uint16_t mPeak = 0;
+        // Remaining time the peak is held
+        uint16_t mHold = 0;
+
+    public:
+        /**
+         * Take over a new measured level, 0 to 255.
+         */
+        void update(uint8_t value)
+        {
+            uint16_t level = (uint16_t) value << 8;
+
+            if (level > mLevel) {
+                mLevel = level;
+            }
+            if (level >= mPeak && level > 0) {
+                mPeak = level;
+                mHold = AUDIO_PEAK_HOLD_MS;
+            }
+        }
+
+        void advance(uint32_t dt)
+        {
+            uint32_t loss = (uint32_t) AUDIO_DECAY_RATE * dt;
+            mLevel = loss < 65536 ? mLevel - ((uint32_t) mLevel * loss >> 16) : 0;
+
+            if (mHold >= dt) {
+                mHold -= dt;
+            } else {
+                uint32_t fall = ((dt - mHold) * AUDIO_PEAK_FALL_SPEED << 8) / 1000;
+                mHold = 0;
+                mPeak = mPeak > fall ? mPeak - fall : 0;
+            }
+            // The peak never drops below the level itself
+            if (mPeak < mLevel) {
+                mPeak = mLevel;
+            }
+        }
+
+        uint8_t value() const { return mLevel >> 8; }
+
+        uint8_t peak() const { return mPeak >> 8; }
+
+        /**
+         * Level in 8.8 fixed point, for effects which interpolate between levels.
+         */
+        uint16_t level16() const { return mLevel; }
+
+        uint16_t peak16() const { return mPeak; }
+};
+
+/**
+ * Levels of all spectrum bands, and the overall volume and bass derived from them.
+ */
+class AudioSpectrum
+{
+    private:
+        AudioLevel mBands[AUDIO_NUM_BANDS];
+        AudioLevel mVolume;
+        AudioLevel mBass;
+
+    public:
+        /**
+         * Take over a received spectrum.
+         *
+         * @param bands: AUDIO_NUM_BANDS levels from bass to treble.
+         */
+        void update(const uint8_t *bands)
+        {
+            uint16_t sum = 0;
+            uint16_t bass = 0;
+
+            for (uint8_t i = 0; i < AUDIO_NUM_BANDS; i++) {
+                mBands[i].update(bands[i]);
+                sum += bands[i];
+                if (i < AUDIO_BASS_BANDS) {
+                    bass += bands[i];
+                }
+            }
+            mVolume.update(sum / AUDIO_NUM_BANDS);
+            mBass.update(bass / AUDIO_BASS_BANDS);
+        }
+
+        /**
+         * Decay the levels and the peaks by the elapsed time.
+         */
+        void advance(uint32_t dt)
+        {
+            for (uint8_t i = 0; i < AUDIO_NUM_BANDS; i++) {
+                mBands[i].advance(dt);
+            }
+            mVolume.advance(dt);
+            mBass.advance(dt);
+        }
+
+        const AudioLevel &band(uint8_t index) const { return mBands[index]; }
+
+        const AudioLevel &volume() const { return mVolume; }
+
+        const AudioLevel &bass() const { return mBass; }
+};
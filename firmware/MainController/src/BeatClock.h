@@ -0,0 +1,107 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Beat generator for tempo driven effects, which keeps its phase across tempo changes.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <FastLED.h>
+
+#include "config.h"
+
+/**
+ * Counts beats by the elapsed time, instead of deriving them from millis() like beat16().
+ *
+ * A new tempo only changes the speed of the phase from then on, so the animations do not jump.
+ * Synchronizing to an external beat bends the phase toward it, by at most a quarter of the
+ * current speed, instead of setting it.
+ */
+class BeatClock
+{
+    private:
+        // Phase step per millisecond and 1/256 BPM is 65536 / (60000 * 256), kept exact as remainder
+        static const uint32_t STEP_DIVISOR = 60000UL * 256;
+
+        // Beats since start, 16.16 fixed point
+        uint32_t mPhase = 0;
+        uint32_t mRemainder = 0;
+        // Beats per minute, 8.8 fixed point
+        uint16_t mBPM = LED_DEFAULT_BPM << 8;
+        // Phase correction still to be applied, toward the last synchronized beat
+        int32_t  mPhaseError = 0;
+
+    public:
+        uint16_t bpm() const { return mBPM; }
+
+        void setBPM(uint16_t bpm) { mBPM = bpm; }
+
+        /**
+         * Bend the phase toward an external beat.
+         *
+         * @param position: position within the current beat of the external clock, in 1/65536 beats.
+         */
+        void sync(uint16_t position)
+        {
+            // Shorter way around, at most half a beat in either direction
+            mPhaseError = (int16_t) (position - (uint16_t) mPhase);
+        }
+
+        /**
+         * Number of 1/65536 beats in the given time at the given tempo, without the remainder.
+         */
+        static uint32_t beatsIn(uint32_t millis, uint16_t bpm)
+        {
+            return ((uint64_t) bpm * millis << 16) / STEP_DIVISOR;
+        }
+
+        void advance(uint32_t dt)
+        {
+            uint64_t steps = ((uint64_t) mBPM * dt << 16) + mRemainder;
+            int32_t step = steps / STEP_DIVISOR;
+            mRemainder = steps % STEP_DIVISOR;
+
+            if (mPhaseError != 0) {
+                int32_t limit = step / 4 + 1;
+                int32_t correction = mPhaseError < -limit ? -limit : (mPhaseError > limit ? limit : mPhaseError);
+                step += correction;
+                mPhaseError -= correction;
+            }
+            mPhase += step;
+        }
+
+        /**
+         * Beats since start, 16.16 fixed point.
+         */
+        uint32_t phase() const { return mPhase; }
+
+        /**
+         * Position within the current beat, like beat16().
+         */
+        uint16_t beat16() const { return mPhase; }
+
+        uint8_t beat8() const { return mPhase >> 8; }
+
+        /**
+         * One sine wave per beat between lowest and highest, like beatsin16().
+         */
+        uint16_t sin16(uint16_t lowest = 0, uint16_t highest = 65535) const
+        {
+            uint16_t wave = ::sin16(beat16()) + 32768;
+            return lowest + scale16(wave, highest - lowest);
+        }
+
+        /**
+         * One sine wave per beat between lowest and highest, like beatsin8().
+         */
+        uint8_t sin8(uint8_t lowest = 0, uint8_t highest = 255) const
+        {
+            return lowest + scale8(::sin8(beat8()), highest - lowest);
+        }
+};
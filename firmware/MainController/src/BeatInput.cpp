@@ -0,0 +1,44 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Beat clock input implementation.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "BeatInput.h"
+
+static const uint8_t BEAT_MAGIC[4] = { 'F', 'L', 'B', 'T' };
+
+static const uint8_t BEAT_PACKET_LENGTH = 8;
+static const uint8_t BEAT_OFFSET_BPM = 4;
+static const uint8_t BEAT_OFFSET_POSITION = 6;
+
+BeatInput::BeatInput()
+: PacketInput("Beat", "beat clock", BEAT_CLOCK_PORT, BEAT_MAGIC, BEAT_PACKET_LENGTH)
+{
+}
+
+bool BeatInput::decode(const uint8_t *packet)
+{
+    uint16_t tempo = ((uint16_t) packet[BEAT_OFFSET_BPM] << 8) | packet[BEAT_OFFSET_BPM + 1];
+    if (tempo < (LED_MIN_BPM << 8) || tempo > (LED_MAX_BPM << 8)) {
+        return false;
+    }
+
+    mBPM = tempo;
+    mPosition = ((uint16_t) packet[BEAT_OFFSET_POSITION] << 8) | packet[BEAT_OFFSET_POSITION + 1];
+    return true;
+}
+
+bool BeatInput::receive(uint16_t &bpm, uint16_t &position)
+{
+    if (!poll()) {
+        return false;
+    }
+    bpm = mBPM;
+    position = mPosition;
+    return true;
+}
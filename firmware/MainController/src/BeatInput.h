@@ -0,0 +1,42 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Receives the tempo and beat position from an external beat clock over UDP.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include "config.h"
+#include "PacketInput.h"
+
+/**
+ * Beat clock input on BEAT_CLOCK_PORT. Owned and polled by the render task.
+ */
+class BeatInput : public PacketInput
+{
+    private:
+        // Latest valid packet
+        uint16_t mBPM = 0;
+        uint16_t mPosition = 0;
+
+    protected:
+        virtual bool decode(const uint8_t *packet);
+
+    public:
+        BeatInput();
+
+        /**
+         * Receive all pending packets.
+         *
+         * @param bpm: tempo of the latest valid packet, in 1/256 BPM.
+         * @param position: position within the current beat of the latest valid packet, in 1/65536 beats.
+         * @return true if a valid packet was received.
+         */
+        bool receive(uint16_t &bpm, uint16_t &position);
+};
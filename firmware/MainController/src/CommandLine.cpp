@@ -16,6 +16,8 @@
 #include <cstring>
 #include <string>
 
+#include "config.h"
+
 bool CommandParser::parseInteger(const char* arg, int &value, int minValue, int maxValue)
 {
     const char* c = arg;
@@ -205,55 +207,100 @@ void CommandLine::processEOL()
 
 void CommandLine::begin()
 {
-    // Serial over USB.
-    Serial.begin(115200);
+    // Serial over USB. The buffer size must be set before begin().
+    Serial.setRxBufferSize(SERIAL_RX_BUFFER_SIZE);
+    Serial.begin(SERIAL_CONSOLE_BAUD);
+}
+
+void CommandLine::processStreamHeader(char c)
+{
+    mStreamHeader[mStreamHeaderLength++] = c;
+
+    CmdParseStatus ret = mStreamParser->parseHeader(mStreamHeader, mStreamHeaderLength);
+
+    if (ret == CmdParseStatus::CPSNextArgument && mStreamHeaderLength < MAX_STREAM_HEADER_LENGTH) {
+        return;
+    }
+    if (ret == CmdParseStatus::CPSComplete) {
+        mStreamHeaderLength = 0;
+        // Drop the partially typed token
+        mTokenLength = 0;
+        mStreaming = true;
+        return;
+    }
+
+    // Not a stream, pass the held back input on to the tokenizer.
+    int length = mStreamHeaderLength;
+    mStreamHeaderLength = 0;
+    for (int i = 0; i < length; i++) {
+        processChar(mStreamHeader[i]);
+    }
 }
 
 void CommandLine::loop()
 {
+    if (mStreaming) {
+        mStreaming = mStreamParser->readStream();
+        return;
+    }
+
     while (Serial.available()) {
         char c = Serial.read();
 
-        // echo inputs
-        Serial.write(c);
-        Serial.flush();
-
-        switch (c) {
-            case '\r':
-                break;
-            case ' ':
-            case '\t':
-            case '\n':
-                if (mTokenLength > 0) {
-                    // zero-terminate token
-                    if (mTokenLength < MAX_TOKEN_LENGTH) {
-                        mToken[mTokenLength++] = '\0';
-                    } else {
-                        // Forcefully terminate at the end. Should never be reached.
-                        mToken[MAX_TOKEN_LENGTH-1] = '\0';
-                    }
-
-                    processToken();
-                    
-                    mTokenLength = 0;
-                }
-                if (c == '\n') {
-                    processEOL();
-                }
-                break;
-            case 8: // Backspace
-                if (mTokenLength > 0) {
-                    mTokenLength--;
-                }
-                break;
-            default:
-                // We leave one byte space in the buffer for zero-terminiation
-                if (mTokenLength < MAX_TOKEN_LENGTH - 1) {
-                    mToken[mTokenLength++] = c;
+        if (!mStreamParser) {
+            processChar(c);
+            continue;
+        }
+
+        processStreamHeader(c);
+        if (mStreaming) {
+            // Remaining input belongs to the stream
+            return;
+        }
+    }
+}
+
+void CommandLine::processChar(char c)
+{
+    // echo inputs
+    Serial.write(c);
+    Serial.flush();
+
+    switch (c) {
+        case '\r':
+            break;
+        case ' ':
+        case '\t':
+        case '\n':
+            if (mTokenLength > 0) {
+                // zero-terminate token
+                if (mTokenLength < MAX_TOKEN_LENGTH) {
+                    mToken[mTokenLength++] = '\0';
                 } else {
-                    // raise error?
+                    // Forcefully terminate at the end. Should never be reached.
+                    mToken[MAX_TOKEN_LENGTH-1] = '\0';
                 }
-                break;
-        }
+
+                processToken();
+                
+                mTokenLength = 0;
+            }
+            if (c == '\n') {
+                processEOL();
+            }
+            break;
+        case 8: // Backspace
+            if (mTokenLength > 0) {
+                mTokenLength--;
+            }
+            break;
+        default:
+            // We leave one byte space in the buffer for zero-terminiation
+            if (mTokenLength < MAX_TOKEN_LENGTH - 1) {
+                mToken[mTokenLength++] = c;
+            } else {
+                // raise error?
+            }
+            break;
     }
 } 
\ No newline at end of file
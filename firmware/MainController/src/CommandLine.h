@@ -66,8 +66,31 @@ class CommandParser
         virtual CmdExecStatus completeCommand(bool expectArgument) = 0;
 };
 
+/**
+ * Binary protocol which takes over the serial port when its header is received.
+ */
+class StreamParser
+{
+    public:
+        /**
+         * Check if the bytes received so far start a stream.
+         *
+         * @return CPSNextArgument if more header bytes are needed, CPSComplete if the header is complete and the
+         *         stream starts, CPSInvalidArgument if the bytes are not a stream header.
+         */
+        virtual CmdParseStatus parseHeader(const uint8_t *header, int length) = 0;
+
+        /**
+         * Read the stream data, called by the command line loop while the stream is active.
+         *
+         * @return false if the stream has ended and the command line takes over again.
+         */
+        virtual bool readStream() = 0;
+};
+
 static const int MAX_PARSERS = 16;
 static const int MAX_TOKEN_LENGTH = 32;
+static const int MAX_STREAM_HEADER_LENGTH = 8;
 
 class CommandLine
 {
@@ -86,6 +109,13 @@ class CommandLine
         // Waiting for an argument?
         bool mExpectArgument = false;
 
+        StreamParser *mStreamParser = nullptr;
+        // Possible stream header, held back from the tokenizer
+        uint8_t mStreamHeader[MAX_STREAM_HEADER_LENGTH];
+        int  mStreamHeaderLength = 0;
+        // Stream parser owns the serial input
+        bool mStreaming = false;
+
         void printHelp();
 
         void printCommandHelp(int cmd);
@@ -106,11 +136,28 @@ class CommandLine
 
         void processEOL();
 
+        void processChar(char c);
+
+        /**
+         * Hold back input which might start a stream, until the header is complete or does not match.
+         */
+        void processStreamHeader(char c);
+
     public:
         explicit CommandLine();
 
         void addCommand(const char* cmd, CommandParser *parser);
 
+        /**
+         * Set the binary protocol which bypasses the command parser after its header.
+         */
+        void setStreamParser(StreamParser *parser) { mStreamParser = parser; }
+
+        /**
+         * The stream parser owns the serial input.
+         */
+        bool isStreaming() const { return mStreaming; }
+
         void begin();
 
         void loop();
@@ -0,0 +1,229 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Overlay compositor implementation.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Compositor.h"
+
+#include "LEDGeometry.h"
+
+// Half width of the sweep band, in 8 bit room coordinates
+static const int16_t SWEEP_HALF_WIDTH = 32;
+
+/**
+ * Blend a solid color over a span of pixels, with the mode selected once per span.
+ */
+static void blendSpan(CRGB *pixels, int length, const CRGB &color, BlendMode mode, uint8_t alpha)
+{
+    switch (mode) {
+        case BLEND_ADD:
+            for (int i = 0; i < length; i++) {
+                pixels[i] += color;
+            }
+            break;
+        case BLEND_MAX:
+            for (int i = 0; i < length; i++) {
+                pixels[i] |= color;
+            }
+            break;
+        case BLEND_ALPHA: {
+            // Same weights as blendPixels(), with the color share computed once per span
+            uint16_t keep = 256 - alpha;
+            uint16_t r = color.r * alpha;
+            uint16_t g = color.g * alpha;
+            uint16_t b = color.b * alpha;
+            for (int i = 0; i < length; i++) {
+                pixels[i].r = (pixels[i].r * keep + r) >> 8;
+                pixels[i].g = (pixels[i].g * keep + g) >> 8;
+                pixels[i].b = (pixels[i].b * keep + b) >> 8;
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * Blend an overlay over a single pixel, partially covered by the given amount.
+ */
+static void blendPixel(CRGB &pixel, const Overlay &overlay, uint8_t coverage)
+{
+    if (overlay.blend == BLEND_ALPHA) {
+        blendSpan(&pixel, 1, overlay.color, BLEND_ALPHA, scale8(overlay.alpha, coverage));
+    } else {
+        CRGB color = overlay.color;
+        blendSpan(&pixel, 1, color.nscale8_video(coverage), overlay.blend, 255);
+    }
+}
+
+Compositor::Compositor()
+{
+    for (uint8_t i = 0; i < LED_NUM_LAYERS; i++) {
+        mLayers[i].overlay.type = OVERLAY_NONE;
+        mLayers[i].elapsed = 0;
+    }
+}
+
+void Compositor::start(uint8_t layer, const Overlay &overlay)
+{
+    mLayers[layer].overlay = overlay;
+    mLayers[layer].elapsed = 0;
+}
+
+bool Compositor::isEmpty() const
+{
+    for (uint8_t i = 0; i < LED_NUM_LAYERS; i++) {
+        const Overlay &overlay = mLayers[i].overlay;
+        if (overlay.type != OVERLAY_NONE && (overlay.type != OVERLAY_GLITTER || overlay.param > 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Compositor::isAnimated() const
+{
+    for (uint8_t i = 0; i < LED_NUM_LAYERS; i++) {
+        const Overlay &overlay = mLayers[i].overlay;
+        if (overlay.type == OVERLAY_NONE) {
+            continue;
+        }
+        if (overlay.lifetimeMillis > 0 || overlay.type == OVERLAY_FLASH || overlay.type == OVERLAY_BLINK ||
+            overlay.type == OVERLAY_SWEEP ||
+            (overlay.type == OVERLAY_GLITTER && overlay.param > 0))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Compositor::advance(uint32_t dt)
+{
+    for (uint8_t i = 0; i < LED_NUM_LAYERS; i++) {
+        Layer &layer = mLayers[i];
+        if (layer.overlay.type == OVERLAY_NONE) {
+            continue;
+        }
+        layer.elapsed += dt;
+        if (layer.overlay.lifetimeMillis > 0 && layer.elapsed >= layer.overlay.lifetimeMillis) {
+            layer.overlay.type = OVERLAY_NONE;
+        }
+    }
+}
+
+void Compositor::render(CRGB *frame, uint32_t dt)
+{
+    for (uint8_t i = 0; i < LED_NUM_LAYERS; i++) {
+        const Layer &layer = mLayers[i];
+
+        switch (layer.overlay.type) {
+            case OVERLAY_NONE:
+                break;
+            case OVERLAY_GLITTER:
+                renderGlitter(layer, frame, dt);
+                break;
+            case OVERLAY_FLASH:
+                renderFlash(layer, frame);
+                break;
+            case OVERLAY_PROGRESS:
+                renderProgress(layer, frame);
+                break;
+            case OVERLAY_BLINK:
+                renderBlink(layer, frame);
+                break;
+            case OVERLAY_SWEEP:
+                renderSweep(layer, frame);
+                break;
+        }
+    }
+}
+
+uint32_t Compositor::cyclePhase(const Layer &layer)
+{
+    const Overlay &overlay = layer.overlay;
+
+    if (overlay.lifetimeMillis > 0) {
+        uint32_t cycles = overlay.param > 0 ? overlay.param : 1;
+        return (uint64_t) layer.elapsed * cycles * 256 / overlay.lifetimeMillis;
+    }
+    return layer.elapsed * 256 / LED_OVERLAY_PERIOD_MS;
+}
+
+void Compositor::renderFlash(const Layer &layer, CRGB *frame)
+{
+    const Overlay &overlay = layer.overlay;
+
+    // Each pulse rises and falls smoothly over its cycle
+    uint8_t level = cubicwave8(cyclePhase(layer));
+    if (level == 0) {
+        return;
+    }
+
+    if (overlay.blend == BLEND_ALPHA) {
+        blendSpan(frame, NUM_LEDS, overlay.color, BLEND_ALPHA, scale8(overlay.alpha, level));
+    } else {
+        CRGB color = overlay.color;
+        blendSpan(frame, NUM_LEDS, color.nscale8_video(level), overlay.blend, 255);
+    }
+}
+
+void Compositor::renderBlink(const Layer &layer, CRGB *frame)
+{
+    const Overlay &overlay = layer.overlay;
+
+    // On for the first half of each cycle
+    if (cyclePhase(layer) & 0x80) {
+        return;
+    }
+    blendSpan(frame, NUM_LEDS, overlay.color, overlay.blend, overlay.alpha);
+}
+
+void Compositor::renderSweep(const Layer &layer, CRGB *frame)
+{
+    const Overlay &overlay = layer.overlay;
+
+    // Band enters at one end of the room and has left at the other end when the cycle is over
+    int16_t center = ((cyclePhase(layer) & 0xFF) * (256 + 2 * SWEEP_HALF_WIDTH) >> 8) - SWEEP_HALF_WIDTH;
+
+    for (int i = 0; i < NUM_LEDS; i++) {
+        int16_t distance = abs(StripGeometry::at(i).x - center);
+        if (distance < SWEEP_HALF_WIDTH) {
+            blendPixel(frame[i], overlay, 255 - distance * (256 / SWEEP_HALF_WIDTH));
+        }
+    }
+}
+
+void Compositor::renderProgress(const Layer &layer, CRGB *frame)
+{
+    const Overlay &overlay = layer.overlay;
+
+    // Length of each bar in 8 bit fractions of a pixel
+    uint32_t length = (uint32_t) overlay.param * StripLayout::HALF_LENGTH * 256 / 255;
+    uint16_t whole = length >> 8;
+    uint8_t fraction = length & 0xFF;
+
+    blendSpan(frame, whole, overlay.color, overlay.blend, overlay.alpha);
+    blendSpan(frame + NUM_LEDS - whole, whole, overlay.color, overlay.blend, overlay.alpha);
+
+    // Partially covered pixel at the tip of each bar, for smooth progress on short strips
+    if (fraction > 0 && whole < StripLayout::HALF_LENGTH) {
+        blendPixel(frame[whole], overlay, fraction);
+        blendPixel(frame[StripLayout::mirrorIndex(whole)], overlay, fraction);
+    }
+}
+
+void Compositor::renderGlitter(const Layer &layer, CRGB *frame, uint32_t dt)
+{
+    const Overlay &overlay = layer.overlay;
+
+    // Chance is given per frame period, scale it to the current frame time
+    uint32_t chance = (uint32_t) overlay.param * dt / LED_FRAME_PERIOD_MS;
+    if (chance > 0 && random8() < (chance < 255 ? chance : 255)) {
+        blendPixel(frame[random16(NUM_LEDS)], overlay, 255);
+    }
+}
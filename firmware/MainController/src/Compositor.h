@@ -0,0 +1,121 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Overlay layers drawn above the effect, each with its own blend mode and lifetime.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <FastLED.h>
+
+#include "config.h"
+
+// Lowest layer, carries the glitter of the current effect
+static const uint8_t LAYER_EFFECT_GLITTER = 0;
+
+enum OverlayType : uint8_t {
+    OVERLAY_NONE,
+    // Random sparkles, param is the chance per frame period
+    OVERLAY_GLITTER,
+    // Whole strip pulses param times over the lifetime, or once per LED_OVERLAY_PERIOD_MS without a lifetime
+    OVERLAY_FLASH,
+    // Bar growing from both ends toward the center, param is the progress from 0 to 255
+    OVERLAY_PROGRESS,
+    // Whole strip switches on and off, with cycles like the flash
+    OVERLAY_BLINK,
+    // Band crossing the room along its length, with cycles like the flash
+    OVERLAY_SWEEP
+};
+
+enum BlendMode : uint8_t {
+    // Add to the pixels below, saturating
+    BLEND_ADD,
+    // Brighter of both, per channel
+    BLEND_MAX,
+    // Cover the pixels below by the overlay alpha
+    BLEND_ALPHA
+};
+
+struct Overlay
+{
+    OverlayType type;
+    BlendMode   blend;
+    CRGB        color;
+    // Opacity with BLEND_ALPHA
+    uint8_t     alpha;
+    uint8_t     param;
+    // Time until the overlay is removed, 0 keeps it until it is cleared
+    uint32_t    lifetimeMillis;
+};
+
+class Compositor
+{
+    private:
+        struct Layer {
+            Overlay  overlay;
+            // Time since the overlay was started
+            uint32_t elapsed;
+        };
+
+        Layer mLayers[LED_NUM_LAYERS];
+
+        /**
+         * Position within the current cycle of a repeating overlay in 1/256, counting the cycles above.
+         */
+        static uint32_t cyclePhase(const Layer &layer);
+
+        void renderFlash(const Layer &layer, CRGB *frame);
+
+        void renderBlink(const Layer &layer, CRGB *frame);
+
+        void renderSweep(const Layer &layer, CRGB *frame);
+
+        void renderProgress(const Layer &layer, CRGB *frame);
+
+        void renderGlitter(const Layer &layer, CRGB *frame, uint32_t dt);
+
+    public:
+        Compositor();
+
+        /**
+         * Start an overlay on a layer, replacing the overlay shown there.
+         */
+        void start(uint8_t layer, const Overlay &overlay);
+
+        void clear(uint8_t layer) { mLayers[layer].overlay.type = OVERLAY_NONE; }
+
+        /**
+         * Change the parameter of an overlay, such as the progress, without restarting it.
+         */
+        void setParam(uint8_t layer, uint8_t param) { mLayers[layer].overlay.param = param; }
+
+        const Overlay &overlay(uint8_t layer) const { return mLayers[layer].overlay; }
+
+        /**
+         * Check if no layer draws anything.
+         */
+        bool isEmpty() const;
+
+        /**
+         * Check if any layer changes the frame over time, or is going to expire.
+         */
+        bool isAnimated() const;
+
+        /**
+         * Advance the lifetimes and remove expired overlays.
+         */
+        void advance(uint32_t dt);
+
+        /**
+         * Draw all layers over the frame, starting with the lowest layer.
+         *
+         * @param dt: time since the previous frame, for the glitter chance.
+         */
+        void render(CRGB *frame, uint32_t dt);
+};
@@ -0,0 +1,821 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * LED strip effects implementation.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "Effects.h"
+
+#include <string.h>
+
+#include "LEDGeometry.h"
+
+// Animation speeds, in hue steps or pixels per second
+static const uint32_t HUE_CYCLE_SPEED = 50;
+// Slow drift through the palette of the effects whose colors come from their own motion
+static const uint32_t HUE_DRIFT_SPEED = 5;
+static const uint32_t CIRCLE_SPEED = 50;
+
+// Fire simulation steps per second
+static const uint32_t FIRE_STEPS_PER_SECOND = 60;
+// Heat loss per step; higher values give shorter flames
+static const uint8_t FIRE_COOLING = 55;
+// Chance of a new spark per step; 0 = none, 255: always
+static const uint8_t FIRE_SPARKING = 120;
+// Sparks ignite within this many pixels from the strip end
+static const uint8_t FIRE_SPARK_ZONE = 7;
+
+// Water simulation steps per second
+static const uint32_t WATER_STEPS_PER_SECOND = 50;
+// Waves lose 1/2^n of their height per step
+static const uint8_t WATER_DAMPING = 5;
+// Chance of a new drop per step; 0 = none, 255: always
+static const uint8_t WATER_DROP_CHANCE = 20;
+static const int16_t WATER_DROP_HEIGHT = 1024;
+static const int32_t WATER_MAX_HEIGHT = 4095;
+
+// Ripple phase steps per second, 256 steps move the waves out by one wavelength
+static const uint32_t RIPPLE_SPEED = 160;
+// Wave crests between the room center and the farthest pixel, 4.4 fixed point
+static const uint8_t RIPPLE_WAVES = 3 << 4;
+
+// Turn of the sweep direction, in 1/256 turns per second
+static const uint32_t SWEEP_TURN_SPEED = 6;
+// Width of the sweeping band; higher values give a narrower band
+static const uint8_t SWEEP_SHARPNESS = 6;
+
+// New meteors per second, alternating between both strip ends
+static const uint32_t METEOR_RATE = 1;
+// Meteor speed range, in pixels per second
+static const uint8_t METEOR_MIN_SPEED = 40;
+static const uint8_t METEOR_MAX_SPEED = 90;
+// Fade of the meteor trails per frame period
+static const uint8_t METEOR_TRAIL_FADE = 40;
+
+// Bursts of sparks per second, each from a random position
+static const uint32_t SPARK_BURST_RATE = 2;
+static const uint8_t SPARK_BURST_SIZE = 12;
+// Largest spark speed in either direction, in pixels per second
+static const uint8_t SPARK_MAX_SPEED = 60;
+static const uint16_t SPARK_MIN_LIFE_MS = 400;
+static const uint16_t SPARK_MAX_LIFE_MS = 1200;
+static const uint8_t SPARK_TRAIL_FADE = 60;
+
+static const uint8_t BALL_COUNT = 4;
+// Gravity pulling the balls back to the strip ends, in 1/256 pixels per second squared
+static const int32_t BALL_GRAVITY = 200 << 8;
+// Share of the speed kept on each bounce
+static const uint8_t BALL_BOUNCE = 230;
+// Launch speed at which a ball just reaches the center of the strip
+static const int32_t BALL_LAUNCH_SPEED = geometry::squareRoot(2.0 * BALL_GRAVITY * (StripLayout::HALF_LENGTH << 8));
+static const uint8_t BALL_TRAIL_FADE = 80;
+
+// Noise lattice cell sizes in pixels and noise speeds in time steps per second, 256 steps per cell
+static const uint8_t LAVA_CELL_PIXELS = 24;
+static const uint16_t LAVA_SPEED = 40;
+static const uint8_t CLOUD_CELL_PIXELS = 32;
+static const uint16_t CLOUD_SPEED = 96;
+static const uint8_t AURORA_CELL_PIXELS = 16;
+static const uint16_t AURORA_SPEED = 60;
+// The curtains are wider and move slower than the colors within them
+static const uint8_t AURORA_CURTAIN_PIXELS = 40;
+static const uint16_t AURORA_CURTAIN_SPEED = 30;
+
+// Hue of the VU meter from green at the strip ends to red at the top of the scale
+static const uint8_t VU_HUE_RANGE = 96;
+// Level taken off the bass pulse at the pixel farthest from the room center, so that the pulse spreads out with the bass
+static const uint8_t BASS_FALLOFF = 160;
+
+static const TProgmemRGBPalette16 AuroraColors_p = {
+    0x000010, 0x002020, 0x004030, 0x00803F, 0x00C060, 0x20FF80, 0x00E090, 0x00A0A0,
+    0x0060C0, 0x2040C0, 0x5020B0, 0x8010A0, 0x600080, 0x300060, 0x100030, 0x000010
+};
+
+
+void EffectContext::setPalette(const CRGBPalette16 &source)
+{
+    for (int i = 0; i < 256; i++) {
+        palette[i] = ColorFromPalette(source, i, 255, LINEARBLEND);
+    }
+}
+
+uint8_t EffectContext::frameAmount(uint8_t amountPerPeriod) const
+{
+    uint32_t amount = (uint32_t) amountPerPeriod * frameDelta / LED_FRAME_PERIOD_MS;
+    return amount < 255 ? amount : 255;
+}
+
+uint8_t EffectContext::frameFadeAmount(uint8_t fadePerPeriod) const
+{
+    // Fading compounds per frame period, interpolate linearly within a period
+    uint8_t keep = 255 - fadePerPeriod;
+    uint8_t scale = 255;
+    uint32_t periods = frameDelta / LED_FRAME_PERIOD_MS;
+    uint32_t remainder = frameDelta % LED_FRAME_PERIOD_MS;
+
+    while (periods-- > 0 && scale > 0) {
+        scale = scale8(scale, keep);
+    }
+    scale = scale8(scale, 255 - fadePerPeriod * remainder / LED_FRAME_PERIOD_MS);
+
+    return 255 - scale;
+}
+
+/* ==================================================== */
+/* Render kernels shared by several effects             */
+/* ==================================================== */
+
+static void cycleHue(EffectContext &ctx, uint32_t speed, uint32_t dt)
+{
+    // Wraps around at 255
+    ctx.hsv.hue += ctx.huePhase.advance(speed, dt);
+}
+
+static void renderFilled(EffectContext &ctx)
+{
+    CHSV fullColor = ctx.hsv;
+    CRGB rgb;
+
+    fullColor.value = 255;
+    hsv2rgb_rainbow(fullColor, rgb);
+
+    fill_solid(ctx.leds, ctx.length, rgb);
+}
+
+static void renderDots(EffectContext &ctx)
+{
+    fadeToBlackBy(ctx.leds, ctx.length, ctx.frameFadeAmount(ctx.fadeSpeed));
+    for (int i = 0; i < ctx.count; i++) {
+        int idx = ctx.param + i*(ctx.length/ctx.count);
+        ctx.leds[idx] = ctx.hsv;
+    }
+}
+
+/**
+ * Fade the previous frame out and add the particles, leaving trails behind the moving ones.
+ */
+static void renderParticles(EffectContext &ctx, uint8_t trailFade)
+{
+    fadeToBlackBy(ctx.leds, ctx.length, ctx.frameFadeAmount(trailFade));
+    ctx.particles.render(ctx.leds, ctx.length);
+}
+
+/**
+ * Colors from the palette along the first noise field.
+ */
+static void renderNoise(EffectContext &ctx)
+{
+    for (int i = 0; i < ctx.length; i++) {
+        ctx.leds[i] = ctx.paletteColor(ctx.noise[0].sample(i));
+    }
+}
+
+/* ==================================================== */
+/* Effects, in RGBMode order                            */
+/* ==================================================== */
+
+struct EffectOn
+{
+    static const RGBMode MODE = RGB_ON;
+    static const bool ANIMATED = false;
+    static constexpr const char *name() { return "on"; }
+
+    static void start(EffectContext &ctx) {}
+    static void step(EffectContext &ctx, uint32_t dt) {}
+    static void render(EffectContext &ctx) { renderFilled(ctx); }
+};
+
+struct EffectCycle
+{
+    static const RGBMode MODE = RGB_CYCLE;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "cycle"; }
+
+    static void start(EffectContext &ctx) {}
+    static void step(EffectContext &ctx, uint32_t dt) { cycleHue(ctx, HUE_CYCLE_SPEED, dt); }
+    static void render(EffectContext &ctx) { renderFilled(ctx); }
+};
+
+struct EffectFire
+{
+    static const RGBMode MODE = RGB_FIRE;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "fire"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.mirrored = true;
+        memset(ctx.heat, 0, sizeof(ctx.heat));
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt)
+    {
+        for (uint32_t steps = ctx.phase.advance(FIRE_STEPS_PER_SECOND, dt); steps > 0; steps--) {
+            simulate(ctx.heat);
+        }
+    }
+
+    static void render(EffectContext &ctx)
+    {
+        // Flames rise from the strip end towards the center, mirrored to the other end
+        for (int i = 0; i < ctx.length && i < StripLayout::HALF_LENGTH; i++) {
+            ctx.leds[i] = HeatColor(ctx.heat[i]);
+        }
+    }
+
+    /**
+     * Advance the heat simulation by one step.
+     */
+    static void simulate(uint8_t *heat)
+    {
+        const uint16_t length = StripLayout::HALF_LENGTH;
+        const uint8_t maxCooling = (FIRE_COOLING * 10) / length + 2;
+
+        // Cool down every cell a little
+        for (uint16_t i = 0; i < length; i++) {
+            heat[i] = qsub8(heat[i], random8(maxCooling));
+        }
+
+        // Heat drifts up and diffuses, weight (1, 2) / 3 as 9 bit fixed point
+        for (uint16_t k = length - 1; k >= 2; k--) {
+            heat[k] = ((uint16_t) (heat[k - 1] + 2 * heat[k - 2]) * 171) >> 9;
+        }
+
+        // Randomly ignite new sparks near the bottom
+        if (random8() < FIRE_SPARKING) {
+            uint8_t y = random8(FIRE_SPARK_ZONE);
+            heat[y] = qadd8(heat[y], random8(160, 255));
+        }
+    }
+};
+
+// Brightness is reduced by the LED driver
+struct EffectDimmed : EffectOn
+{
+    static const RGBMode MODE = RGB_DIMMED;
+    static constexpr const char *name() { return "dimmed"; }
+};
+
+struct EffectSpin
+{
+    static const RGBMode MODE = RGB_SPIN;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "spin"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.count = 2;
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt)
+    {
+        ctx.param = (ctx.param + ctx.phase.advance(CIRCLE_SPEED, dt)) % StripLayout::HALF_LENGTH;
+    }
+
+    static void render(EffectContext &ctx) { renderDots(ctx); }
+};
+
+struct EffectScan
+{
+    static const RGBMode MODE = RGB_SCAN;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "scan"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.mirrored = true;
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt)
+    {
+        // Sweep along the side, up to the center block
+        ctx.param = ctx.beat.sin16(0, StripLayout::SIDE_LENGTH - 1);
+    }
+
+    static void render(EffectContext &ctx) { renderDots(ctx); }
+};
+
+struct EffectJuggle
+{
+    static const RGBMode MODE = RGB_JUGGLE;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "juggle"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.setPalette(PartyColors_p);
+        ctx.count = 5;
+        ctx.param = 6;
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt) { cycleHue(ctx, HUE_CYCLE_SPEED, dt); }
+
+    static void render(EffectContext &ctx)
+    {
+        // colored dots, weaving in and out of sync with each other
+        fadeToBlackBy(ctx.leds, ctx.length, ctx.frameFadeAmount(ctx.fadeSpeed));
+        for (int i = 0; i < ctx.count; i++) {
+            CRGB color = ctx.paletteColor(ctx.hsv.hue+(i*127)/ctx.count);
+            int idx = beatsin16(i+ctx.param, 0, ctx.length-1);
+            ctx.leds[idx] |= color;
+        }
+    }
+};
+
+struct EffectBPM
+{
+    static const RGBMode MODE = RGB_BPM;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "bpm"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.setPalette(PartyColors_p);
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt)
+    {
+        cycleHue(ctx, HUE_CYCLE_SPEED, dt);
+        ctx.param = ctx.beat.sin8(64, 255);
+    }
+
+    static void render(EffectContext &ctx)
+    {
+        fadeToBlackBy(ctx.leds, ctx.length, ctx.frameFadeAmount(ctx.fadeSpeed));
+        for (int i = 0; i < ctx.length-1; i++) {
+            ctx.leds[i] = ctx.paletteColor(ctx.hsv.hue + (i*2), ctx.param - ctx.hsv.hue + (i*10));
+        }
+    }
+};
+
+struct EffectRainbow
+{
+    static const RGBMode MODE = RGB_RAINBOW;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "rainbow"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.glitterChance = 80;
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt) { cycleHue(ctx, HUE_CYCLE_SPEED, dt); }
+
+    static void render(EffectContext &ctx)
+    {
+        fill_rainbow(ctx.leds, ctx.length, ctx.hsv.hue, 7);
+    }
+};
+
+struct EffectWater
+{
+    static const RGBMode MODE = RGB_WATER;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "water"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.setPalette(OceanColors_p);
+        ctx.mirrored = true;
+        ctx.glitterChance = 30;
+        memset(ctx.waveHeight, 0, sizeof(ctx.waveHeight));
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt)
+    {
+        cycleHue(ctx, HUE_DRIFT_SPEED, dt);
+        for (uint32_t steps = ctx.phase.advance(WATER_STEPS_PER_SECOND, dt); steps > 0; steps--) {
+            simulate(ctx);
+        }
+    }
+
+    static void render(EffectContext &ctx)
+    {
+        const int16_t *height = ctx.waveHeight[ctx.waveCurrent];
+
+        for (int i = 0; i < ctx.length; i++) {
+            // Crests are lighter and brighter, troughs darker
+            int level = 128 + (height[i] >> 4);
+            level = level < 0 ? 0 : (level > 255 ? 255 : level);
+            ctx.leds[i] = ctx.paletteColor(ctx.hsv.hue + (level >> 1), 96 + (level * 5 >> 3));
+        }
+    }
+
+    /**
+     * Advance the wave simulation by one step.
+     */
+    static void simulate(EffectContext &ctx)
+    {
+        const int length = ctx.mirrored ? StripLayout::HALF_LENGTH : NUM_LEDS;
+        const int16_t *current = ctx.waveHeight[ctx.waveCurrent];
+        // The previous step is overwritten by the next one
+        int16_t *next = ctx.waveHeight[ctx.waveCurrent ^ 1];
+
+        // 1D wave equation with reflecting ends: h' = h[i-1] + h[i+1] - h_prev, with damping
+        for (int i = 0; i < length; i++) {
+            int32_t left = current[i > 0 ? i - 1 : i];
+            int32_t right = current[i < length - 1 ? i + 1 : i];
+            int32_t h = left + right - next[i];
+
+            h -= h >> WATER_DAMPING;
+            next[i] = h < -WATER_MAX_HEIGHT ? -WATER_MAX_HEIGHT : (h > WATER_MAX_HEIGHT ? WATER_MAX_HEIGHT : h);
+        }
+        ctx.waveCurrent ^= 1;
+
+        if (random8() < WATER_DROP_CHANCE) {
+            next[random16(length)] = random8() < 128 ? WATER_DROP_HEIGHT : -WATER_DROP_HEIGHT;
+        }
+    }
+};
+
+struct EffectRipple
+{
+    static const RGBMode MODE = RGB_RIPPLE;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "ripple"; }
+
+    static void start(EffectContext &ctx)
+    {
+        // Distances from the room center are the same on both halves
+        ctx.mirrored = true;
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt)
+    {
+        ctx.param = (ctx.param + ctx.phase.advance(RIPPLE_SPEED, dt)) & 0xFF;
+    }
+
+    static void render(EffectContext &ctx)
+    {
+        CHSV fullColor = ctx.hsv;
+        CRGB rgb;
+
+        fullColor.value = 255;
+        hsv2rgb_rainbow(fullColor, rgb);
+
+        for (int i = 0; i < ctx.length; i++) {
+            uint8_t level = sin8(radialPhase(StripGeometry::at(i), RIPPLE_WAVES, ctx.param));
+            ctx.leds[i] = rgb;
+            ctx.leds[i].nscale8_video(level);
+        }
+    }
+};
+
+struct EffectSweep
+{
+    static const RGBMode MODE = RGB_SWEEP;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "sweep"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.setPalette(RainbowColors_p);
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt)
+    {
+        cycleHue(ctx, HUE_CYCLE_SPEED, dt);
+        // The band goes back and forth while its direction slowly turns around the room
+        ctx.angle += ctx.phase.advance(SWEEP_TURN_SPEED, dt);
+        ctx.param = ctx.beat.sin8();
+    }
+
+    static void render(EffectContext &ctx)
+    {
+        SweepAxis axis(ctx.angle);
+
+        for (int i = 0; i < ctx.length; i++) {
+            uint8_t position = axis.position(StripGeometry::at(i));
+            uint8_t offset = position > ctx.param ? position - ctx.param : ctx.param - position;
+            ctx.leds[i] = ctx.paletteColor(ctx.hsv.hue + (position >> 1), qsub8(255, qmul8(offset, SWEEP_SHARPNESS)));
+        }
+    }
+};
+
+struct EffectMeteor
+{
+    static const RGBMode MODE = RGB_METEOR;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "meteor"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.particles.clear();
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt)
+    {
+        cycleHue(ctx, HUE_CYCLE_SPEED, dt);
+        // Meteors leave the strip at the far end, so they do not need a lifetime
+        ctx.particles.step(dt, 0, 0, ctx.length);
+
+        for (uint32_t spawns = ctx.phase.advance(METEOR_RATE, dt); spawns > 0; spawns--) {
+            int32_t speed = random8(METEOR_MIN_SPEED, METEOR_MAX_SPEED) << 8;
+            CRGB color = CHSV(ctx.hsv.hue + random8(32), 192, 255);
+
+            ctx.param ^= 1;
+            if (ctx.param) {
+                ctx.particles.spawn(((int32_t) ctx.length << 8) - 1, -speed, PARTICLE_IMMORTAL, color);
+            } else {
+                ctx.particles.spawn(0, speed, PARTICLE_IMMORTAL, color);
+            }
+        }
+    }
+
+    static void render(EffectContext &ctx) { renderParticles(ctx, METEOR_TRAIL_FADE); }
+};
+
+struct EffectSparks
+{
+    static const RGBMode MODE = RGB_SPARKS;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "sparks"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.setPalette(HeatColors_p);
+        ctx.particles.clear();
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt)
+    {
+        ctx.particles.step(dt, 0, 0, ctx.length);
+
+        for (uint32_t bursts = ctx.phase.advance(SPARK_BURST_RATE, dt); bursts > 0; bursts--) {
+            int32_t origin = (int32_t) random16(ctx.length) << 8;
+
+            for (uint8_t i = 0; i < SPARK_BURST_SIZE && !ctx.particles.isFull(); i++) {
+                int32_t speed = (int32_t) random16(SPARK_MAX_SPEED << 9) - (SPARK_MAX_SPEED << 8);
+                // Hot colors from the upper half of the heat palette
+                ctx.particles.spawn(origin, speed, random16(SPARK_MIN_LIFE_MS, SPARK_MAX_LIFE_MS),
+                                    ctx.paletteColor(random8(128, 255)));
+            }
+        }
+    }
+
+    static void render(EffectContext &ctx) { renderParticles(ctx, SPARK_TRAIL_FADE); }
+};
+
+struct EffectBalls
+{
+    static const RGBMode MODE = RGB_BALLS;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "balls"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.setPalette(PartyColors_p);
+        // Balls bounce up from the strip ends toward the center
+        ctx.mirrored = true;
+        ctx.count = BALL_COUNT;
+        ctx.particles.clear();
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt)
+    {
+        ParticlePool<LED_MAX_PARTICLES> &balls = ctx.particles;
+
+        cycleHue(ctx, HUE_DRIFT_SPEED, dt);
+        balls.step(dt, BALL_GRAVITY, BALL_BOUNCE, ctx.length);
+
+        // Kick balls back up once their bounces got too low
+        for (uint16_t i = 0; i < balls.count(); i++) {
+            if (balls.position[i] < 256 && balls.velocity[i] > 0 && balls.velocity[i] < BALL_LAUNCH_SPEED / 4) {
+                balls.velocity[i] = launchSpeed();
+            }
+        }
+
+        // Balls overshooting the center are removed by the pool, replace them
+        while (balls.count() < ctx.count) {
+            balls.spawn(0, launchSpeed(), PARTICLE_IMMORTAL, ctx.paletteColor(ctx.hsv.hue + balls.count() * 256 / ctx.count));
+        }
+    }
+
+    static void render(EffectContext &ctx) { renderParticles(ctx, BALL_TRAIL_FADE); }
+
+    static int32_t launchSpeed()
+    {
+        return BALL_LAUNCH_SPEED * random8(160, 255) >> 8;
+    }
+};
+
+struct EffectLava
+{
+    static const RGBMode MODE = RGB_LAVA;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "lava"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.setPalette(LavaColors_p);
+        ctx.noise[0].start(random8(), LAVA_CELL_PIXELS, LAVA_SPEED);
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt) { ctx.noise[0].advance(dt); }
+
+    static void render(EffectContext &ctx) { renderNoise(ctx); }
+};
+
+struct EffectAurora
+{
+    static const RGBMode MODE = RGB_AURORA;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "aurora"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.setPalette(AuroraColors_p);
+        ctx.noise[0].start(random8(), AURORA_CELL_PIXELS, AURORA_SPEED);
+        ctx.noise[1].start(random8(), AURORA_CURTAIN_PIXELS, AURORA_CURTAIN_SPEED);
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt)
+    {
+        ctx.noise[0].advance(dt);
+        ctx.noise[1].advance(dt);
+    }
+
+    static void render(EffectContext &ctx)
+    {
+        for (int i = 0; i < ctx.length; i++) {
+            // Steep curve, so that the curtains are separated by dark gaps
+            uint8_t level = ease8InOutCubic(ctx.noise[1].sample(i));
+            ctx.leds[i] = ctx.paletteColor(ctx.noise[0].sample(i), level);
+        }
+    }
+};
+
+struct EffectClouds
+{
+    static const RGBMode MODE = RGB_CLOUDS;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "clouds"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.setPalette(CloudColors_p);
+        ctx.noise[0].start(random8(), CLOUD_CELL_PIXELS, CLOUD_SPEED);
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt) { ctx.noise[0].advance(dt); }
+
+    static void render(EffectContext &ctx) { renderNoise(ctx); }
+};
+
+struct EffectVU
+{
+    static const RGBMode MODE = RGB_VU;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "vu"; }
+
+    static void start(EffectContext &ctx)
+    {
+        // The meter rises from both strip ends toward the center
+        ctx.mirrored = true;
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt) {}
+
+    static void render(EffectContext &ctx)
+    {
+        const AudioLevel &volume = ctx.audio.volume();
+
+        // Top of the bar in 1/256 pixels, the last pixel is lit by the fraction
+        int32_t top = (uint32_t) volume.level16() * ctx.length >> 8;
+        int peak = (uint32_t) volume.peak16() * ctx.length >> 16;
+
+        for (int i = 0; i < ctx.length; i++) {
+            int32_t lit = top - ((int32_t) i << 8);
+            uint8_t level = lit > 255 ? 255 : (lit > 0 ? lit : 0);
+            ctx.leds[i] = CHSV(VU_HUE_RANGE - i * VU_HUE_RANGE / ctx.length, 255, level);
+        }
+        if (volume.peak() > 0 && peak < ctx.length) {
+            ctx.leds[peak] = CRGB::White;
+        }
+    }
+};
+
+struct EffectBass
+{
+    static const RGBMode MODE = RGB_BASS;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "bass"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.setPalette(PartyColors_p);
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt) { cycleHue(ctx, HUE_DRIFT_SPEED, dt); }
+
+    static void render(EffectContext &ctx)
+    {
+        // Steeper than linear, so that the beats stand out against the sustained bass
+        uint8_t level = dim8_video(ctx.audio.bass().value());
+
+        for (int i = 0; i < ctx.length; i++) {
+            uint8_t distance = StripGeometry::at(i).distance;
+            ctx.leds[i] = ctx.paletteColor(ctx.hsv.hue + (distance >> 2), qsub8(level, scale8(distance, BASS_FALLOFF)));
+        }
+    }
+};
+
+struct EffectSpectrum
+{
+    static const RGBMode MODE = RGB_SPECTRUM;
+    static const bool ANIMATED = true;
+    static constexpr const char *name() { return "spectrum"; }
+
+    static void start(EffectContext &ctx)
+    {
+        ctx.setPalette(RainbowColors_p);
+        // Bass at the strip ends, treble at the center
+        ctx.mirrored = true;
+    }
+
+    static void step(EffectContext &ctx, uint32_t dt) { cycleHue(ctx, HUE_DRIFT_SPEED, dt); }
+
+    static void render(EffectContext &ctx)
+    {
+        int last = ctx.length > 1 ? ctx.length - 1 : 1;
+
+        for (int i = 0; i < ctx.length; i++) {
+            // Position between the bands, 16.16 fixed point
+            uint32_t position = (uint32_t) i * ((AUDIO_NUM_BANDS - 1) << 16) / last;
+            uint8_t band = position >> 16;
+            uint8_t next = band < AUDIO_NUM_BANDS - 1 ? band + 1 : band;
+            uint8_t fraction = position >> 8;
+
+            int32_t low = ctx.audio.band(band).level16();
+            int32_t high = ctx.audio.band(next).level16();
+            uint8_t level = (low + ((high - low) * fraction >> 8)) >> 8;
+
+            // One sixteenth of the palette per band
+            ctx.leds[i] = ctx.paletteColor(ctx.hsv.hue + (position >> 12), dim8_video(level));
+        }
+    }
+};
+
+/* ==================================================== */
+/* Registry                                             */
+/* ==================================================== */
+
+using RGBEffects = EffectRegistry<
+    EffectOn,
+    EffectCycle,
+    EffectFire,
+    EffectDimmed,
+    EffectSpin,
+    EffectScan,
+    EffectJuggle,
+    EffectBPM,
+    EffectRainbow,
+    EffectWater,
+    EffectRipple,
+    EffectSweep,
+    EffectMeteor,
+    EffectSparks,
+    EffectBalls,
+    EffectLava,
+    EffectAurora,
+    EffectClouds,
+    EffectVU,
+    EffectBass,
+    EffectSpectrum
+>;
+
+uint8_t numEffects()
+{
+    return RGBEffects::size;
+}
+
+const EffectInfo &effectAt(uint8_t index)
+{
+    return RGBEffects::table[index];
+}
+
+const EffectInfo *findEffect(RGBMode mode)
+{
+    return mode < RGBEffects::size ? &RGBEffects::table[mode] : nullptr;
+}
+
+const char *strRGBMode(RGBMode mode)
+{
+    const EffectInfo *effect = findEffect(mode);
+    return effect ? effect->name : "";
+}
+
+bool parseRGBMode(const char *str, RGBMode &mode)
+{
+    for (uint8_t i = 0; i < RGBEffects::size; i++) {
+        if (strcmp(str, RGBEffects::table[i].name) == 0) {
+            mode = RGBEffects::table[i].mode;
+            return true;
+        }
+    }
+    return false;
+}
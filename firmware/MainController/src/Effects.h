@@ -0,0 +1,197 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * LED strip effects and the registry mapping RGB modes to effects.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <FastLED.h>
+
+#include <commands.h>
+
+#include "config.h"
+#include "PhaseAccumulator.h"
+#include "Particles.h"
+#include "NoiseField.h"
+#include "BeatClock.h"
+#include "AudioSpectrum.h"
+
+/**
+ * State shared by the effects, owned by the render task.
+ */
+class EffectContext
+{
+    public:
+        // Pixels to render; only the first half of the strip for mirrored effects
+        CRGB    *leds = nullptr;
+        int      length = NUM_LEDS;
+
+        // Time elapsed since the previous frame
+        uint32_t frameDelta = LED_FRAME_PERIOD_MS;
+
+        // Current color, animated by some effects
+        CHSV     hsv;
+
+        /* Reset before an effect is started */
+
+        int      param = 0;
+        int      count = 1;
+        // Direction of spatial effects, 0 to 255 for a full turn
+        uint8_t  angle = 0;
+        // Mirror the effect on both sides, otherwise use the full length
+        bool     mirrored = false;
+        // Add some glitter effect; 0 = off, 255: full
+        uint8_t  glitterChance = 0;
+        // Animation speeds are given per second, the accumulator keeps the fractional steps between frames.
+        PhaseAccumulator phase;
+
+        /* Kept across effects */
+
+        PhaseAccumulator huePhase;
+
+        // Beat of the tempo driven effects, set by the LED driver every frame
+        BeatClock beat;
+        // Audio levels of the audio reactive effects, set by the LED driver every frame
+        AudioSpectrum audio;
+        // Speed to fade out old pixels
+        uint8_t  fadeSpeed = 20;
+
+        // Fire effect temperature per pixel, from the strip end towards the center
+        uint8_t  heat[StripLayout::HALF_LENGTH];
+
+        // Water effect surface height, current and previous step
+        int16_t  waveHeight[2][NUM_LEDS];
+        uint8_t  waveCurrent = 0;
+
+        // Moving objects of the particle effects
+        ParticlePool<LED_MAX_PARTICLES> particles;
+
+        // Noise of the noise effects, for the colors and for the brightness
+        NoiseField noise[2];
+
+        // Palette of the current effect, expanded to one entry per palette index
+        CRGB     palette[256];
+
+        /**
+         * Expand the palette into the palette cache.
+         */
+        void setPalette(const CRGBPalette16 &source);
+
+        /**
+         * Color from the cached palette, scaled like ColorFromPalette().
+         */
+        CRGB paletteColor(uint8_t index, uint8_t brightness = 255) const
+        {
+            CRGB color = palette[index];
+
+            if (brightness != 255) {
+                // Same rounding as ColorFromPalette()
+                color.nscale8(brightness ? brightness + 1 : 0);
+            }
+            return color;
+        }
+
+        /**
+         * Scale a per-frame-period amount (fade speed, glitter chance) to the current frame time.
+         */
+        uint8_t frameAmount(uint8_t amountPerPeriod) const;
+
+        /**
+         * Fade amount which has the same effect over the current frame time as fadePerPeriod applied once per frame period.
+         */
+        uint8_t frameFadeAmount(uint8_t fadePerPeriod) const;
+};
+
+/**
+ * Registry entry of an effect.
+ */
+struct EffectInfo
+{
+    RGBMode     mode;
+    const char *name;
+    // Static effects only change the frame on state changes
+    bool        animated;
+
+    // Set up the context for the effect
+    void (*start)(EffectContext &ctx);
+    // Advance the effect by dt milliseconds and render into ctx.leds
+    void (*frame)(EffectContext &ctx, uint32_t dt);
+};
+
+/**
+ * Frame hook of an effect type, so that a frame costs a single indirect call.
+ */
+template<typename Effect>
+void effectFrame(EffectContext &ctx, uint32_t dt)
+{
+    Effect::step(ctx, dt);
+    Effect::render(ctx);
+}
+
+/**
+ * Registry entry of an effect type. An effect type provides:
+ *  - static const RGBMode MODE and static const bool ANIMATED
+ *  - static constexpr const char *name()
+ *  - static void start(EffectContext&), step(EffectContext&, uint32_t dt), render(EffectContext&)
+ */
+template<typename Effect>
+constexpr EffectInfo effectInfo()
+{
+    return EffectInfo{ Effect::MODE, Effect::name(), Effect::ANIMATED, &Effect::start, &effectFrame<Effect> };
+}
+
+/**
+ * Check that the effect types are listed in RGB mode order, starting at Index.
+ */
+template<uint8_t Index, typename... Effects>
+struct EffectsInModeOrder
+{
+    static const bool value = true;
+};
+
+template<uint8_t Index, typename First, typename... Rest>
+struct EffectsInModeOrder<Index, First, Rest...>
+{
+    static const bool value = First::MODE == Index && EffectsInModeOrder<Index + 1, Rest...>::value;
+};
+
+/**
+ * Table of all effect types, built at compile time and indexed by RGB mode.
+ */
+template<typename... Effects>
+struct EffectRegistry
+{
+    static_assert(EffectsInModeOrder<0, Effects...>::value, "Effects must be listed in RGBMode order");
+
+    static const uint8_t size = sizeof...(Effects);
+    static const EffectInfo table[sizeof...(Effects)];
+};
+
+template<typename... Effects>
+const EffectInfo EffectRegistry<Effects...>::table[sizeof...(Effects)] = { effectInfo<Effects>()... };
+
+/**
+ * Number of registered effects.
+ */
+uint8_t numEffects();
+
+/**
+ * Registered effect by index, in RGB mode order.
+ */
+const EffectInfo &effectAt(uint8_t index);
+
+/**
+ * Effect for an RGB mode, nullptr if there is none.
+ */
+const EffectInfo *findEffect(RGBMode mode);
+
+const char *strRGBMode(RGBMode mode);
+
+bool parseRGBMode(const char *str, RGBMode &mode);
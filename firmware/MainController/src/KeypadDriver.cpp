@@ -106,8 +106,12 @@ void KeypadDriver::processKeypadCommand(uint8_t data)
             break;
         case CMD_RGB_MODE:
             if (UARTBufferLength >= 2) {
-                Serial.printf("[Kbd] Set RGB mode: %s\n", strRGBMode((RGBMode) UARTBuffer[1]));
-                mLEDs.setRGBMode((RGBMode) UARTBuffer[1]);
+                if (findEffect((RGBMode) UARTBuffer[1])) {
+                    Serial.printf("[Kbd] Set RGB mode: %s\n", strRGBMode((RGBMode) UARTBuffer[1]));
+                    mLEDs.setRGBMode((RGBMode) UARTBuffer[1]);
+                } else {
+                    Serial.printf("[Kbd] Unknown RGB mode %hhu\n", UARTBuffer[1]);
+                }
                 UARTBufferLength = 0;
             }
             break;
@@ -132,6 +136,12 @@ void KeypadDriver::processKeypadCommand(uint8_t data)
                 UARTBufferLength = 0;
             }
             break;
+        case CMD_TAP_TEMPO:
+            if (UARTBufferLength >= 2) {
+                mLEDs.tapTempo();
+                UARTBufferLength = 0;
+            }
+            break;
         case CMD_REQUEST_STATUS:
             if (UARTBufferLength >= 2) {
                 mProjector.requestStatus();
@@ -9,8 +9,6 @@
  * See 'COPYRIGHT.txt' for copyright and licensing information.
  */
 
-//#define FASTLED_ESP32_I2S
-
 #include "LED.h"
 
 #include <functional>
@@ -20,8 +18,10 @@
 #include <commands.h>
 
 #include <FastLED.h>
+#include <WiFi.h>
 
 #include "config.h"
+#include "LoopProfiler.h"
 
 const char *TOPIC_LIGHT_ENABLE = "light";
 const char *TOPIC_LAMPS_ENABLE = "lamps";
@@ -31,14 +31,66 @@ const char *TOPIC_DIMMED_INTENSITY = "dimmed";
 const char *TOPIC_RGBMODE = "mode";
 const char *TOPIC_COLOR_HSV = "hsv";
 const char *TOPIC_COLOR_RGB = "rgb";
+const char *TOPIC_TRANSITION = "transition";
+const char *TOPIC_NOTIFY = "notify";
+const char *TOPIC_BPM = "bpm";
+
+static const CRGB STRIP_CORRECTION = CRGB(TypicalLEDStrip);
+
+// Lamp outputs have not been written yet
+static const uint16_t LAMP_PWM_UNKNOWN = 0xFFFF;
+
+static const uint8_t LAMP_PINS[NUM_LAMPS] = { PIN_LAMP1, PIN_LAMP2 };
+
+// Strip fade times, the fade speeds in pixels per second follow from the strip length
+static const uint32_t FADE_IN_MS = 750;
+static const uint32_t FADE_OUT_MS = 560;
+static const uint32_t FADE_IN_SPEED = StripLayout::HALF_LENGTH * 1000UL / FADE_IN_MS;
+static const uint32_t FADE_OUT_SPEED = StripLayout::HALF_LENGTH * 1000UL / FADE_OUT_MS;
+
+// Notification durations, per blink for NOTIFY_BLINK
+static const uint32_t NOTIFY_PULSE_MS = 1000;
+static const uint32_t NOTIFY_SWEEP_MS = 1200;
+static const uint32_t NOTIFY_BLINK_MS = 400;
 
+static const char *NOTIFY_ANIMATIONS[] = { "pulse", "sweep", "blink" };
 
-LEDDriver::LEDDriver(Settings &settings, MqttClient &mqttClient)
-: mSettings(settings), mMqttClient(mqttClient)
+bool parseNotifyAnimation(const char *str, NotifyAnimation &animation)
+{
+    for (uint8_t i = 0; i < sizeof(NOTIFY_ANIMATIONS) / sizeof(NOTIFY_ANIMATIONS[0]); i++) {
+        if (strcmp(str, NOTIFY_ANIMATIONS[i]) == 0) {
+            animation = (NotifyAnimation) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseHexColor(const char *str, CRGB &color)
+{
+    if (str[0] != '#' || strlen(str) != 7 || strspn(str + 1, "0123456789abcdefABCDEF") != 6) {
+        return false;
+    }
+    color = CRGB(strtol(str + 1, 0, 16));
+    return true;
+}
+
+
+LEDDriver::LEDDriver(Settings &settings, MqttClient &mqttClient, LEDOutput &output)
+: mSettings(settings), mMqttClient(mqttClient), mOutput(output)
 {
     for (uint8_t i = 0; i < NUM_LAMPS; i++) {
         mIntensity[i] = 0;
+        mLampDuty[i] = LAMP_PWM_UNKNOWN;
     }
+    for (uint8_t i = 0; i < LED_NUM_LAYERS; i++) {
+        mOverlays[i].type = OVERLAY_NONE;
+        mOverlaySerial[i] = 0;
+        mOverlayStart[i] = 0;
+    }
+
+    // Sparkles of the effects, as they were drawn onto the effect pixels before
+    mCompositor.start(LAYER_EFFECT_GLITTER, Overlay{ OVERLAY_GLITTER, BLEND_ADD, CRGB::White, 255, 0, 0 });
 }
 
 void LEDDriver::updateLamps()
@@ -53,306 +105,614 @@ void LEDDriver::updateLamps()
         mIntensity[LED_LAMP2] = 0;
     }
 
-    analogWrite(PIN_LAMP1, 255 - mIntensity[LED_LAMP1]);
-    analogWrite(PIN_LAMP2, 255 - mIntensity[LED_LAMP2]);
+    // Renderer eases the outputs toward the new intensity
+    publishRenderState();
 }
 
-void LEDDriver::updateLEDs() {
-    CHSV fullColor = mHSV;
-    CRGB rgb;
+void LEDDriver::renderEffect(const EffectInfo *effect, EffectContext &ctx, CRGB *leds, uint32_t dt)
+{
+    // Mirrored effects only render the first half, including half of the center segment
+    ctx.leds = leds;
+    ctx.length = ctx.mirrored ? StripLayout::HALF_LENGTH : NUM_LEDS;
+    ctx.frameDelta = dt;
+    ctx.beat = mBeat;
+    ctx.audio = mAudio;
 
-    CHSV hsv2;
-    CRGB rgb2;
-
-    int i;
-
-    fullColor.value = 255;
-    hsv2rgb_rainbow(fullColor, rgb);
-
-    if (mAnimation != ANIM_NONE) {
-        switch (mEffect) {
-            case EF_FILLED:
-                fill_solid(mLEDs, NUM_LEDS, rgb);
-                break;
-            case EF_BAR:
-                // get half-bright pixel color
-                hsv2 = mHSV;
-                hsv2.v = mHSV.v/2;
-                hsv2rgb_rainbow(hsv2, rgb2);
-
-                for (int i = 0; i < NUM_LEDS; i++) {
-                    CRGB color;
-                    if (i < mEffectParam || (mEffectMirrored && i > NUM_LEDS - 1 - mEffectParam)) {
-                        color = rgb;
-                    }
-                    else if (i == mEffectParam || (mEffectMirrored && i == NUM_LEDS - 1 - mEffectParam)) {
-                        color = rgb2;
-                    }
-                    else {
-                        color = CRGB::Black;
-                    }
-                    mLEDs[i] = color;
-                }
-                break;
-            case EF_DOT:
-                fadeToBlackBy(mLEDs, NUM_LEDS, mFadeSpeed);
-                for (i = 0; i < mEffectCount; i++) {
-                    int idx = mEffectParam + i*(NUM_LEDS/mEffectCount);
-                    mLEDs[idx] = mHSV;
-                    if (mEffectMirrored) {
-                        mLEDs[NUM_LEDS - 1 - idx] = mHSV;
-                    }
-                }
-                break;
-            case EF_FIRE:
-                // TODO
-                break;
-            case EF_JUGGLE:
-                // colored dots, weaving in and out of sync with each other
-                fadeToBlackBy(mLEDs, NUM_LEDS, mFadeSpeed);
-                for (i = 0; i < mEffectCount; i++) {
-                    rgb2 = ColorFromPalette(mEffectPalette, mHSV.hue+(i*127)/mEffectCount, 255);
-                    int idx = beatsin16(i+mEffectParam, 0, mEffectMirrored ? NUM_LEDS/2 : NUM_LEDS-1);
-                    mLEDs[idx] |= rgb2;
-                    if (mEffectMirrored) {
-                        mLEDs[NUM_LEDS - 1 - idx] |= rgb2;
-                    }
-                }
-                break;
-            case EF_BPM:
-                fadeToBlackBy(mLEDs, NUM_LEDS, mFadeSpeed);
-                for (i = 0; i < NUM_LEDS-1; i++) {
-                    mLEDs[i] = ColorFromPalette(mEffectPalette, mHSV.hue + (i*2), mEffectParam - mHSV.hue + (i*10));
-                }
-                break;
-            case EF_RAINBOW:
-                fill_rainbow(mLEDs, NUM_LEDS, mHSV.hue, 7);
-                break;
-            case EF_WATER:
-                // TODO
-                break;
-        }
-
-        if (mGlitterChance > 0) {
-            if ( random8() < mGlitterChance ) {
-                mLEDs[ random16(NUM_LEDS) ] += CRGB::White;
-            }
-        }
+    effect->frame(ctx, dt);
 
-        int brightness = mHSV.value;
+    // Masked before mirroring, so that mirrored effects only mask the rendered half
+    if (mFadeEffect != FADE_OFF) {
+        applyFadeMask(leds, ctx.length);
+    }
+    if (ctx.mirrored) {
+        StripLayout::mirror(leds);
+    }
+}
 
-        if (mFadeEffect != FADE_OFF) {
-            for (int i = mFadeParam; i < NUM_LEDS / 2; i++) {
-                mLEDs[i] = CRGB::Black;
-                mLEDs[NUM_LEDS - 1 - i] = CRGB::Black;
-            }
-            brightness = (brightness * mFadeParam * 2) / NUM_LEDS;
+void LEDDriver::applyFadeMask(CRGB *leds, int length)
+{
+    int end = length < NUM_LEDS ? length : NUM_LEDS - mFadeParam;
+
+    for (int i = mFadeParam; i < end; i++) {
+        leds[i] = CRGB::Black;
+    }
+}
+
+void LEDDriver::updateLEDs(uint32_t dt)
+{
+    renderEffect(mEffect, mEffectContext, mLEDs, dt);
+
+    if (mCrossfading && mOutgoingEffect) {
+        renderEffect(mOutgoingEffect, mOutgoingContext, mOutgoingLEDs, dt);
+    }
+
+    finishFrame(true);
+}
+
+uint32_t LEDDriver::brightnessLevel(bool dimmed) const
+{
+    uint32_t level = (uint32_t) mEffectContext.hsv.value * 257;
+
+    if (mFadeEffect != FADE_OFF) {
+        level = (level * mFadeParam * 2) / NUM_LEDS;
+    }
+    if (dimmed) {
+        level = (level * mDimmedRamp.value()) / 255;
+    }
+    return level;
+}
+
+uint8_t LEDDriver::crossfadeAmount() const
+{
+    return ease8InOutCubic(mCrossfadeElapsed * 255 / mCrossfadeDuration);
+}
+
+uint8_t LEDDriver::effectGlitterChance() const
+{
+    uint8_t chance = mEffectContext.glitterChance;
+
+    if (mCrossfading && mOutgoingEffect) {
+        return lerp8by8(mOutgoingContext.glitterChance, chance, crossfadeAmount());
+    }
+    return chance;
+}
+
+void LEDDriver::finishFrame(bool masked)
+{
+    CRGB *frame = mLEDs;
+    uint32_t level = brightnessLevel(mApplied.mode == RGB_DIMMED);
+
+    if (mCrossfading) {
+        uint8_t amount = crossfadeAmount();
+
+        frame = nextOutputBuffer();
+        blendPixels(mOutgoingLEDs, mLEDs, frame, NUM_LEDS, amount);
+
+        // Blend the brightness as well when fading from or to the dimmed mode
+        int32_t outgoingLevel = brightnessLevel(mOutgoingDimmed);
+        level = outgoingLevel + (((int32_t) level - outgoingLevel) * amount) / 256;
+    }
+
+    if (!mCompositor.isEmpty()) {
+        if (frame == mLEDs) {
+            // Overlays are drawn on a copy, so that the effect keeps drawing on its own pixels
+            frame = nextOutputBuffer();
+            memcpy(frame, mLEDs, sizeof(CRGB) * NUM_LEDS);
         }
+        mCompositor.render(frame, mFrameDelta);
+    }
 
-        if (mRGBMode == RGB_DIMMED) {
-            FastLED.setBrightness((brightness * mDimmedIntensity)/ 255);
-        } else {
-            FastLED.setBrightness(brightness);
+    // Overlays and realtime frames have not been masked yet
+    if (mFadeEffect != FADE_OFF && (!masked || !mCompositor.isEmpty())) {
+        applyFadeMask(frame, NUM_LEDS);
+    }
+
+    if (mApplied.dither) {
+        showDithered(frame, nextOutputBuffer(), level);
+        return;
+    }
+
+    mBrightness = level >> 8;
+    if (frame == mLEDs) {
+        showFrame();
+    } else {
+        sendFrame(frame);
+    }
+}
+
+void LEDDriver::showFrame()
+{
+    CRGB *front = mLEDs;
+
+    if (!sendFrame(front)) {
+        return;
+    }
+
+    // Continue drawing on a copy of the frame just sent, the output driver may still read the front buffer.
+    mLEDs = (front == mFrameBuffer[0]) ? mFrameBuffer[1] : mFrameBuffer[0];
+    memcpy(mLEDs, front, sizeof(CRGB) * NUM_LEDS);
+}
+
+CRGB *LEDDriver::nextOutputBuffer()
+{
+    return (mShownFrame == mOutputBuffer[0]) ? mOutputBuffer[1] : mOutputBuffer[0];
+}
+
+void LEDDriver::showDithered(const CRGB *pixels, CRGB *output, uint32_t level)
+{
+    // Color correction is applied here, the strip controller sends the dithered values unchanged.
+    uint16_t scale[3];
+    for (int c = 0; c < 3; c++) {
+        scale[c] = (level * (STRIP_CORRECTION.raw[c] + 1)) >> 8;
+    }
+
+    mDitherResidual = mDither.apply(pixels, output, NUM_LEDS, scale);
+
+    mBrightness = 255;
+    sendFrame(output);
+}
+
+bool LEDDriver::sendFrame(CRGB *front)
+{
+    uint8_t brightness = mBrightness;
+
+    // The strip keeps the last frame, only send out changes.
+    if (!mForceShow && mShownFrame && brightness == mShownBrightness &&
+        memcmp(front, mShownFrame, sizeof(CRGB) * NUM_LEDS) == 0)
+    {
+        return false;
+    }
+    mForceShow = false;
+    mShownBrightness = brightness;
+    // The output driver may still read this buffer, it is not drawn on until the next frame has been sent.
+    mShownFrame = front;
+
+    unsigned long start = micros();
+    mOutput.show(front, brightness);
+    uint32_t showTime = micros() - start;
+
+    mShowMicros = mShowMicros == 0 ? showTime : (mShowMicros * 7 + showTime) / 8;
+    mShowCount++;
+    return true;
+}
+
+bool LEDDriver::isStaticAnimation() const
+{
+    if (mFadeEffect != FADE_OFF || mNextEffect || mPowerOffPending || mCrossfading) {
+        return false;
+    }
+    if (mHueRamp.isActive() || mSaturationRamp.isActive() || mValueRamp.isActive() || mDimmedRamp.isActive() ||
+        mLampRamp[LED_LAMP1].isActive() || mLampRamp[LED_LAMP2].isActive())
+    {
+        return false;
+    }
+    if (mRealtime.isActive() || (mApplied.dither && mDitherResidual)) {
+        return false;
+    }
+    return (!mEffect || !mEffect->animated) && !mCompositor.isAnimated();
+}
+
+uint32_t LEDDriver::nextFramePeriod() const
+{
+    if (isStaticAnimation()) {
+        // Only poll for state changes
+        return LED_FRAME_PERIOD_MS;
+    }
+    return adaptiveFramePeriod(mShowMicros);
+}
+
+uint32_t LEDDriver::adaptiveFramePeriod(uint32_t showMicros)
+{
+    // Leave a quarter of the period for rendering and the other tasks on the core
+    uint32_t period = (showMicros * 5 / 4 + 999) / 1000;
+    if (period < LED_MIN_FRAME_PERIOD_MS) {
+        return LED_MIN_FRAME_PERIOD_MS;
+    }
+    // Long strips may take longer than LED_FRAME_PERIOD_MS to send, but the animations must not get choppy
+    return period < LED_MAX_FRAME_PERIOD_MS ? period : LED_MAX_FRAME_PERIOD_MS;
+}
+
+void LEDDriver::updateFrameStats()
+{
+    mRenderCount++;
+
+    unsigned long elapsed = mLastFrameTime - mStatsStart;
+    if (elapsed >= 1000) {
+        mRenderRate = (uint32_t) mRenderCount * 1000 / elapsed;
+        mShowRate = (uint32_t) mShowCount * 1000 / elapsed;
+        mRenderCount = 0;
+        mShowCount = 0;
+        mStatsStart = mLastFrameTime;
+    }
+}
+
+void LEDDriver::updateRamps(uint32_t dt)
+{
+    if (mHueRamp.advance(dt)) {
+        mEffectContext.hsv.hue = mHueRamp.value();
+    }
+    if (mSaturationRamp.advance(dt)) {
+        mEffectContext.hsv.sat = mSaturationRamp.value();
+    }
+    if (mValueRamp.advance(dt)) {
+        mEffectContext.hsv.val = mValueRamp.value();
+    }
+    mDimmedRamp.advance(dt);
+}
+
+void LEDDriver::updateLampOutputs(uint32_t dt)
+{
+    for (uint8_t i = 0; i < NUM_LAMPS; i++) {
+        mLampRamp[i].advance(dt);
+
+        uint16_t duty = lampDuty(mLampRamp[i].value16());
+        if (duty != mLampDuty[i]) {
+            // Lamp drivers are active low
+            analogWrite(LAMP_PINS[i], LAMP_PWM_MAX - duty);
+            mLampDuty[i] = duty;
         }
-        FastLED.show();
     }
 }
 
-void LEDDriver::updateAnimation()
+void LEDDriver::updateTransition(uint32_t dt)
 {
-    switch (mAnimation) {
-        case ANIM_NONE:
-        case ANIM_ON:
-        case ANIM_DISABLED:
-            break;
-        case ANIM_JUGGLE:
-        case ANIM_COLORCYCLE:
-        case ANIM_RAINBOW:
-            // Color cycle, wrap around at 255
-            mHSV[0]++;
-            break;
-        case ANIM_FADE_BAR_IN:
-            mEffectParam += 3;
-            break;
-        case ANIM_FADE_BAR_OUT:
-            mEffectParam -= 4;
-            break;
-        case ANIM_CIRCLE:
-            mEffectParam = (mEffectParam + 1) % (NUM_LEDS / 2);
-            break;
-        case ANIM_SCAN:
-            mEffectParam = beatsin16(mEffectBPM, 0, (NUM_LEDS-NUM_LEDS_CENTER)/2 - 1);
-            break;
-        case ANIM_FIRE:
-        case ANIM_WATER:
-        case ANIM_BPM:
-            mHSV[0]++;
-            mEffectParam = beatsin8(mEffectBPM, 64, 255);
-            break;
+    if (mCrossfading) {
+        mCrossfadeElapsed += dt;
+        if (mCrossfadeElapsed >= mCrossfadeDuration) {
+            mCrossfading = false;
+            mOutgoingEffect = nullptr;
+        }
     }
 
     if (mFadeEffect == FADE_IN) {
-        mFadeParam += 3;
-        if (mFadeParam >= NUM_LEDS / 2) {
+        mFadeParam += mFadePhase.advance(FADE_IN_SPEED, dt);
+        if (mFadeParam >= StripLayout::HALF_LENGTH) {
             mFadeEffect = FADE_OFF;
         }
     }
     if (mFadeEffect == FADE_OUT) {
-        mFadeParam -= 4;
+        mFadeParam -= mFadePhase.advance(FADE_OUT_SPEED, dt);
         if (mFadeParam < 0) {
             mFadeEffect = FADE_OFF;
         }
     }
 
-    // check for finished animation after updating fade state, so that next animation starts as soon as fade is finished.
-    if (isAnimationFinished() && mNextAnimation != ANIM_NONE) {
-        startAnimation(mNextAnimation);        
-        mNextAnimation = ANIM_NONE;
+    // check after updating the fade state, so that the next effect starts as soon as the fade is finished.
+    if (mFadeEffect != FADE_OFF) {
+        return;
+    }
+    if (mPowerOffPending) {
+        digitalWrite(PIN_RGB_PWR, LOW);
+        mPowerOffPending = false;
+        startEffect(nullptr);
+    }
+    if (mNextEffect) {
+        if (mEffect && mApplied.transitionMillis > 0) {
+            startCrossfade(mNextEffect);
+        } else {
+            startEffect(mNextEffect);
+        }
+        mNextEffect = nullptr;
+    }
+}
+
+void LEDDriver::publishRenderState()
+{
+    RenderState &state = mRenderState.writeBuffer();
+
+    state.stripEnabled = mEnableLEDStrip;
+    state.mode = mRGBMode;
+    state.hsv = mHSV;
+    state.dimmedIntensity = mDimmedIntensity;
+    state.dither = mDitherEnabled;
+    state.transitionMillis = mTransitionMillis;
+    state.rampMillis = mRampMillis;
+    for (uint8_t i = 0; i < NUM_LAMPS; i++) {
+        state.lampIntensity[i] = mIntensity[i];
+    }
+    for (uint8_t i = 0; i < LED_NUM_LAYERS; i++) {
+        state.overlays[i] = mOverlays[i];
+        state.overlaySerial[i] = mOverlaySerial[i];
     }
+    state.bpm = mBPM;
+    state.beatSerial = mBeatSerial;
+    state.beatMillis = mBeatMillis;
 
-    if (mAnimation != ANIM_NONE) {
-        updateLEDs();
+    mRenderState.publish();
+}
+
+/**
+ * Ease from the current value toward a new target, or retarget the running ramp.
+ */
+static void retarget(ValueRamp &ramp, uint8_t current, uint8_t target, uint32_t millis)
+{
+    if (!ramp.isActive()) {
+        // Effects may have moved the value on their own
+        ramp.set(current);
     }
+    ramp.moveTo(target, millis);
 }
 
-void LEDDriver::startAnimation(LEDAnimation animation)
+void LEDDriver::applyRenderState(const RenderState &state)
 {
-    if (mAnimation == animation) {
-        // Dont reset current animation if already started
-        return;
+    // Changes are applied immediately while the strip is dark
+    uint32_t rampMillis = mEffect ? state.rampMillis : 0;
+
+    CHSV &hsv = mEffectContext.hsv;
+    if (state.hsv.h != mApplied.hsv.h) {
+        retarget(mHueRamp, hsv.h, state.hsv.h, rampMillis);
+        hsv.h = mHueRamp.value();
+    }
+    if (state.hsv.s != mApplied.hsv.s) {
+        retarget(mSaturationRamp, hsv.s, state.hsv.s, rampMillis);
+        hsv.s = mSaturationRamp.value();
+    }
+    if (state.hsv.v != mApplied.hsv.v) {
+        retarget(mValueRamp, hsv.v, state.hsv.v, rampMillis);
+        hsv.v = mValueRamp.value();
+    }
+    if (state.dimmedIntensity != mApplied.dimmedIntensity) {
+        retarget(mDimmedRamp, mDimmedRamp.value(), state.dimmedIntensity, rampMillis);
+    }
+    for (uint8_t i = 0; i < NUM_LAMPS; i++) {
+        if (state.lampIntensity[i] != mApplied.lampIntensity[i]) {
+            mLampRamp[i].moveTo(state.lampIntensity[i], state.rampMillis);
+        }
+    }
+
+    for (uint8_t i = LAYER_EFFECT_GLITTER + 1; i < LED_NUM_LAYERS; i++) {
+        if (state.overlaySerial[i] != mApplied.overlaySerial[i]) {
+            mCompositor.start(i, state.overlays[i]);
+        } else if (state.overlays[i].param != mApplied.overlays[i].param) {
+            mCompositor.setParam(i, state.overlays[i].param);
+        }
     }
 
-    mAnimation = animation;
+    if (state.bpm != mApplied.bpm) {
+        mBeat.setBPM(state.bpm);
+    }
+    if (state.beatSerial != mApplied.beatSerial) {
+        mTapSyncPending = true;
+    }
 
-    mEffectCount = 1;
-    mEffectMirrored = false;
-    mGlitterChance = 0;
+    if (state.dither != mApplied.dither) {
+        // Dithering takes over color correction and temporal dithering from the controller
+        mOutput.setCorrection(state.dither ? CRGB(UncorrectedColor) : STRIP_CORRECTION);
+        mOutput.setDither(state.dither ? DISABLE_DITHER : BINARY_DITHER);
+        mDither.reset();
+        mDitherResidual = false;
+        mForceShow = true;
+    }
 
-    // Set the effect for the animation
-    switch (mAnimation) {
-        case ANIM_DISABLED:
-            // Disable power and turn off
-            digitalWrite(PIN_RGB_PWR, LOW);
-            mAnimation = ANIM_NONE;
-            // fallthrough..
-        case ANIM_NONE:
-        case ANIM_ON:
-        case ANIM_COLORCYCLE:
-            mEffect = EF_FILLED;
-            break;
-        case ANIM_FADE_BAR_IN:
-            mEffect = EF_BAR;
-            if (!isFadeAnimation()) {
-                mEffectParam = 0;
-            }
-            mEffectMirrored = true;
-            break;
-        case ANIM_FADE_BAR_OUT:
-            mEffect = EF_BAR;
-            if (!isFadeAnimation()) {
-                mEffectParam = NUM_LEDS / 2;
+    if (state.stripEnabled != mApplied.stripEnabled) {
+        if (state.stripEnabled) {
+            digitalWrite(PIN_RGB_PWR, HIGH);
+            // Strip lost its contents while powered down
+            mForceShow = true;
+            startFading(false, getEffect(state.mode));
+        } else {
+            // Power will be disabled after finish fading
+            startFading(true, nullptr);
+        }
+    } else if (state.stripEnabled && state.mode != mApplied.mode) {
+        mNextEffect = getEffect(state.mode);
+    }
+
+    mApplied = state;
+}
+
+void LEDDriver::renderFrame()
+{
+    if (mRenderState.update()) {
+        applyRenderState(mRenderState.read());
+    }
+
+    unsigned long now = millis();
+    mFrameDelta = now - mLastFrameTime;
+    mLastFrameTime = now;
+    if (mFrameDelta > LED_MAX_FRAME_DELTA_MS) {
+        mFrameDelta = LED_MAX_FRAME_DELTA_MS;
+    }
+
+    updateRamps(mFrameDelta);
+    updateLampOutputs(mFrameDelta);
+    updateTransition(mFrameDelta);
+    mCompositor.advance(mFrameDelta);
+    updateBeat(mFrameDelta);
+    updateAudio(mFrameDelta);
+
+    bool realtime = updateRealtime();
+
+    // Glitter belongs to the effect, it pauses with the effect during realtime input
+    mCompositor.setParam(LAYER_EFFECT_GLITTER, realtime ? 0 : effectGlitterChance());
+
+    if (mEffect) {
+        if (realtime) {
+            // Pixels have been received into the back buffer, the effect is paused until the input times out.
+            // A frame split over several packets is held back until its last packet has arrived.
+            if (!mRealtime.isFramePending()) {
+                finishFrame();
             }
-            mEffectMirrored = true;
-            break;
-        case ANIM_CIRCLE:
-            mEffect = EF_DOT;
-            mEffectCount = 2;
-            mEffectMirrored = false;
-            break;
-        case ANIM_SCAN:
-            mEffect = EF_DOT;
-            mEffectCount = 1;
-            mEffectMirrored = true;
-            break;
-        case ANIM_FIRE:
-            mEffect = EF_BPM;
-            mEffectPalette = HeatColors_p;
-            mGlitterChance = 100;
-            break;
-        case ANIM_JUGGLE:
-            mEffect = EF_JUGGLE;
-            mEffectPalette = PartyColors_p;
-            mEffectCount = 5;
-            mEffectParam = 6;
-            mEffectMirrored = false;
-            break;
-        case ANIM_BPM:
-            mEffect = EF_BPM;
-            mEffectPalette = PartyColors_p;
-            break;
-        case ANIM_RAINBOW:
-            mEffect = EF_RAINBOW;
-            mGlitterChance = 80;
-            break;
-        case ANIM_WATER:
-            mEffect = EF_BPM;
-            mEffectPalette = OceanColors_p;
-            mGlitterChance = 30;
-            break;
+        } else {
+            updateLEDs(mFrameDelta);
+        }
     }
+
+    updateFrameStats();
+    mFramePeriod = nextFramePeriod();
 }
 
-void LEDDriver::startFading(bool fadeOut, LEDAnimation nextAnimation)
+bool LEDDriver::updateRealtime()
 {
-    if (fadeOut) {
-        if (mFadeEffect == FADE_OFF) {
-            mFadeParam = NUM_LEDS / 2;
+    // Sockets need the network stack, which is brought up with the WiFi connection
+    if (!mRealtime.isStarted() && WiFi.isConnected()) {
+        mRealtime.begin();
+    }
+
+    // Frames are only shown while the strip is on, drop them otherwise
+    mRealtime.receive(mEffect ? mLEDs : nullptr, mLastFrameTime);
+
+    if (mStreamFrame.update() && mEffect) {
+        memcpy(mLEDs, mStreamFrame.read().pixels, sizeof(CRGB) * NUM_LEDS);
+        mRealtime.frameReceived(mLastFrameTime);
+    }
+
+    return mRealtime.update(mLastFrameTime);
+}
+
+void LEDDriver::updateBeat(uint32_t dt)
+{
+    if (!mBeatInput.isStarted() && WiFi.isConnected()) {
+        mBeatInput.begin();
+    }
+
+    // The beat positions below are given for the current frame time, which the beat reaches here
+    mBeat.advance(dt);
+
+    if (mTapSyncPending) {
+        // Position the beat has reached since the last tap
+        mBeat.sync(BeatClock::beatsIn(mLastFrameTime - mApplied.beatMillis, mApplied.bpm));
+        mTapSyncPending = false;
+    }
+
+    uint16_t bpm;
+    uint16_t position;
+    if (mBeatInput.receive(bpm, position)) {
+        mBeat.setBPM(bpm);
+        mBeat.sync(position);
+    }
+}
+
+void LEDDriver::updateAudio(uint32_t dt)
+{
+    if (!mAudioInput.isStarted() && WiFi.isConnected()) {
+        mAudioInput.begin();
+    }
+
+    // Decay first, so that a new spectrum is shown at its full level in this frame
+    mAudio.advance(dt);
+
+    uint8_t bands[AUDIO_NUM_BANDS];
+    if (mAudioInput.receive(bands)) {
+        mAudio.update(bands);
+    }
+}
+
+#ifdef LED_RENDER_TASK
+void LEDDriver::renderTask(void *param)
+{
+    LEDDriver *driver = (LEDDriver*) param;
+
+    TickType_t lastWake = xTaskGetTickCount();
+
+#ifdef __PLATFORMIO_BUILD_DEBUG__
+    UBaseType_t lowestFree = RENDER_TASK_STACK;
+#endif
+
+    for (;;) {
+        TickType_t period = pdMS_TO_TICKS(driver->mFramePeriod);
+
+        // Animations advance by elapsed time, so skip missed frames instead of rendering them back to back
+        if (xTaskGetTickCount() - lastWake > period) {
+            lastWake = xTaskGetTickCount();
         }
-        mFadeEffect = FADE_OUT;
-        setNextAnimation(nextAnimation);
-    } else {
-        if (mFadeEffect == FADE_OFF) {
-            mFadeParam = 0;
+        vTaskDelayUntil(&lastWake, period);
+
+        if (driver->mProfiler) {
+            driver->mProfiler->start(PROF_LEDS);
         }
-        mFadeEffect = FADE_IN;
-        startAnimation(nextAnimation);
+        driver->renderFrame();
+        if (driver->mProfiler) {
+            driver->mProfiler->stop(PROF_LEDS);
+        }
+
+#ifdef __PLATFORMIO_BUILD_DEBUG__
+        // Log every new low, the last one logged is the high-water mark to size RENDER_TASK_STACK by
+        UBaseType_t freeStack = uxTaskGetStackHighWaterMark(nullptr);
+        if (freeStack < lowestFree) {
+            lowestFree = freeStack;
+            Serial.printf("[LED] Render task stack: %u of %u bytes free\n", (unsigned) freeStack, (unsigned) RENDER_TASK_STACK);
+        }
+#endif
     }
 }
+#endif
 
-bool LEDDriver::isAnimationFinished() const
+const EffectInfo *LEDDriver::getEffect(RGBMode mode)
 {
-    if (mAnimation == ANIM_FADE_BAR_IN && mEffectParam < NUM_LEDS / 2) {
-        return false;
-    } 
-    if (mAnimation == ANIM_FADE_BAR_OUT && mEffectParam > 0) {
-        return false;
+    const EffectInfo *effect = findEffect(mode);
+    return effect ? effect : findEffect(RGB_ON);
+}
+
+void LEDDriver::startEffect(const EffectInfo *effect)
+{
+    if (mEffect == effect) {
+        // Dont reset current effect if already started
+        return;
     }
-    if (mFadeEffect != FADE_OFF) {
-        return false;
+
+    mEffect = effect;
+    if (!effect) {
+        return;
     }
-    // All other animations immediately terminate
-    return true;
+
+    EffectContext &ctx = mEffectContext;
+    ctx.param = 0;
+    ctx.count = 1;
+    ctx.angle = 0;
+    ctx.mirrored = false;
+    ctx.glitterChance = 0;
+    ctx.phase.reset();
+
+    effect->start(ctx);
 }
 
-LEDDriver::LEDAnimation LEDDriver::getAnimation(RGBMode mode)
+void LEDDriver::startCrossfade(const EffectInfo *effect)
 {
-    switch (mode) {
-        case RGB_ON:
-        case RGB_DIMMED:
-            return ANIM_ON;
-        case RGB_CYCLE:
-            return ANIM_COLORCYCLE;
-        case RGB_FIRE:
-            return ANIM_FIRE;
-        case RGB_SPIN:
-            return ANIM_CIRCLE;
-        case RGB_SCAN:
-            return ANIM_SCAN;
-        case RGB_JUGGLE:
-            return ANIM_JUGGLE;
-        case RGB_BPM:
-            return ANIM_BPM;
-        case RGB_RAINBOW:
-            return ANIM_RAINBOW;
-        case RGB_WATER:
-            return ANIM_WATER;
+    if (mEffect == effect) {
+        return;
     }
-    return ANIM_NONE;
+
+    if (mCrossfading) {
+        // Continue from the current mix as a still frame, so that the strip does not jump
+        blendPixels(mOutgoingLEDs, mLEDs, mOutgoingLEDs, NUM_LEDS, crossfadeAmount());
+        mOutgoingEffect = nullptr;
+    } else {
+        // Outgoing effect continues on a copy of its pixels and state
+        memcpy(mOutgoingLEDs, mLEDs, sizeof(CRGB) * NUM_LEDS);
+        mOutgoingContext = mEffectContext;
+        mOutgoingEffect = mEffect;
+    }
+    mOutgoingDimmed = mEffect->mode == RGB_DIMMED;
+
+    mCrossfading = true;
+    mCrossfadeElapsed = 0;
+    mCrossfadeDuration = mApplied.transitionMillis;
+
+    // Incoming effect starts drawing over the last frame
+    startEffect(effect);
 }
 
-void LEDDriver::setNextAnimation(LEDAnimation animation)
+void LEDDriver::startFading(bool fadeOut, const EffectInfo *nextEffect)
 {
-    mNextAnimation = animation;
+    if (fadeOut) {
+        if (mFadeEffect == FADE_OFF) {
+            mFadeParam = StripLayout::HALF_LENGTH;
+            mFadePhase.reset();
+        }
+        mFadeEffect = FADE_OUT;
+        mNextEffect = nextEffect;
+        mPowerOffPending = nextEffect == nullptr;
+    } else {
+        if (mFadeEffect == FADE_OFF) {
+            mFadeParam = 0;
+            mFadePhase.reset();
+        }
+        mFadeEffect = FADE_IN;
+        mNextEffect = nullptr;
+        mPowerOffPending = false;
+        startEffect(nextEffect);
+    }
 }
 
 void LEDDriver::mqttCallback(const char *key, const char* payload, unsigned int length)
@@ -432,6 +792,50 @@ void LEDDriver::mqttCallback(const char *key, const char* payload, unsigned int
             }
         }
     }
+    if (strcmp(key, TOPIC_TRANSITION) == 0) {
+        // Duration in seconds, like the Home Assistant light transition
+        float val;
+        int result = sscanf(payload, "%f", &val);
+        if (result == 1 && val >= 0 && val * 1000 <= LED_MAX_TRANSITION_MS) {
+            setTransition(val * 1000 + 0.5f, false);
+        }
+    }
+    if (strcmp(key, TOPIC_BPM) == 0) {
+        float val;
+        int result = sscanf(payload, "%f", &val);
+        if (result == 1 && val >= LED_MIN_BPM && val <= LED_MAX_BPM) {
+            setBPM(val * 256 + 0.5f, false);
+        }
+    }
+    if (strcmp(key, TOPIC_NOTIFY) == 0) {
+        // <pulse|sweep|blink> [<count>] [#rrggbb]
+        char name[16];
+        char colorCode[16];
+        int count = 1;
+        int consumed = 0;
+
+        if (sscanf(payload, "%15s%n", name, &consumed) != 1) {
+            return;
+        }
+        NotifyAnimation animation;
+        if (!parseNotifyAnimation(name, animation)) {
+            Serial.printf("[LED] Unknown notification: %s\n", name);
+            return;
+        }
+        const char *args = payload + consumed;
+        int n;
+        if (sscanf(args, "%d%n", &count, &n) == 1) {
+            args += n;
+        }
+        CRGB color = CRGB::White;
+        if (sscanf(args, "%15s", colorCode) == 1 && !parseHexColor(colorCode, color)) {
+            Serial.printf("[LED] Invalid notification color: %s\n", colorCode);
+            return;
+        }
+        if (count >= 1 && count <= LED_NOTIFY_MAX_BLINKS) {
+            notify(animation, color, count);
+        }
+    }
     if (strcmp(key, TOPIC_COLOR_HSV) == 0) {
         JsonDocument doc;
 
@@ -465,6 +869,11 @@ void LEDDriver::subscribeCallback()
     mMqttClient.publish(MQS_LEDS, TOPIC_RGBMODE, strRGBMode(mRGBMode), true);
 
     publishColor(true);
+    publishTransition(true);
+    publishBPM(true);
+
+    // Notifications are commands, there is no state to publish
+    mMqttClient.subscribe(MQS_LEDS, TOPIC_NOTIFY);
 }
 
 void LEDDriver::appendHexCode(String &rgb, uint8_t val) {
@@ -496,6 +905,21 @@ void LEDDriver::publishColor(bool subscribe) {
     mMqttClient.publish(MQS_LEDS, TOPIC_COLOR_RGB, sRGB.c_str(), subscribe);
 }
 
+void LEDDriver::publishTransition(bool subscribe) {
+    char seconds[16];
+    snprintf(seconds, sizeof(seconds), "%u.%03u", mTransitionMillis / 1000, mTransitionMillis % 1000);
+
+    mMqttClient.publish(MQS_LEDS, TOPIC_TRANSITION, seconds, subscribe);
+}
+
+void LEDDriver::publishBPM(bool subscribe) {
+    char bpm[16];
+    // Two decimals are enough to show 1/256 BPM steps
+    snprintf(bpm, sizeof(bpm), "%u.%02u", mBPM >> 8, ((mBPM & 0xFF) * 100 + 128) >> 8);
+
+    mMqttClient.publish(MQS_LEDS, TOPIC_BPM, bpm, subscribe);
+}
+
 void LEDDriver::enableLamps(bool enabled, bool publish)
 {
     if (mEnableLamps == enabled) {
@@ -520,14 +944,7 @@ void LEDDriver::enableLEDStrip(bool enabled, bool publish)
     mEnableLEDStrip = enabled;
     mSettings.setLEDStripEnabled(enabled);
 
-    if (enabled) {
-        digitalWrite(PIN_RGB_PWR, HIGH);
-        startFading(false, getAnimation(mRGBMode));
-    } else {
-        // Power will be disabled after finish fading
-        startFading(true, ANIM_DISABLED);
-    }
-
+    // Renderer powers the strip up and fades in or out
     updateLamps();
 
     if (publish) {
@@ -545,7 +962,6 @@ void LEDDriver::setRGBMode(RGBMode mode, bool publish)
     }
     mRGBMode = mode;
     mSettings.setRGBMode(mode);
-    setNextAnimation( getAnimation(mode) );
     updateLamps();
     
     if (publish) {
@@ -553,6 +969,81 @@ void LEDDriver::setRGBMode(RGBMode mode, bool publish)
     }
 }
 
+void LEDDriver::enableDither(bool enabled)
+{
+    if (mDitherEnabled == enabled) {
+        return;
+    }
+    mDitherEnabled = enabled;
+    mSettings.setDitherEnabled(enabled);
+    publishRenderState();
+}
+
+void LEDDriver::setTransition(uint32_t millis, bool publish)
+{
+    if (mTransitionMillis == millis) {
+        return;
+    }
+    mTransitionMillis = millis;
+    publishRenderState();
+
+    if (publish) {
+        publishTransition();
+    }
+}
+
+void LEDDriver::setRampTime(uint16_t millis)
+{
+    if (mRampMillis == millis) {
+        return;
+    }
+    mRampMillis = millis;
+    mSettings.setRampTime(millis);
+    publishRenderState();
+}
+
+void LEDDriver::setBPM(uint16_t bpm, bool publish)
+{
+    if (mBPM == bpm) {
+        return;
+    }
+    mBPM = bpm;
+    publishRenderState();
+
+    if (publish) {
+        publishBPM();
+    }
+}
+
+void LEDDriver::tapTempo()
+{
+    unsigned long now = millis();
+
+    if (mTapCount == 0 || now - mLastTap > TAP_TIMEOUT_MS) {
+        mTapCount = 0;
+        mFirstTap = now;
+    }
+    if (mTapCount < 255) {
+        mTapCount++;
+    }
+    mLastTap = now;
+
+    // The beat falls on every tap, also on the first one of a measurement
+    mBeatMillis = now;
+    mBeatSerial++;
+
+    if (mTapCount >= 2) {
+        // Average over all taps of the measurement, so that the tempo settles while tapping on
+        uint32_t interval = (now - mFirstTap) / (mTapCount - 1);
+        uint32_t bpm = interval > 0 ? (60000UL * 256 + interval / 2) / interval : LED_MAX_BPM << 8;
+
+        bpm = bpm < (LED_MIN_BPM << 8) ? LED_MIN_BPM << 8 : (bpm > (LED_MAX_BPM << 8) ? LED_MAX_BPM << 8 : bpm);
+        Serial.printf("[LED] Tapped tempo: %u BPM\n", (unsigned) ((bpm + 128) >> 8));
+        setBPM(bpm);
+    }
+    publishRenderState();
+}
+
 void LEDDriver::setIntensity(uint8_t value, bool publish)
 {
     if (mLightIntensity == value) {
@@ -595,26 +1086,130 @@ void LEDDriver::setHSV(uint8_t hue, uint8_t saturation, uint8_t value, bool publ
     }
     mHSV.setHSV(hue, saturation, value);
     mSettings.setHSV(hue, saturation, value);
-    updateLEDs();
+    publishRenderState();
     if (publish) {
         publishColor();
     }
 }
 
+bool LEDDriver::isOverlayFinished(uint8_t layer, unsigned long now) const
+{
+    const Overlay &overlay = mOverlays[layer];
+    return overlay.type == OVERLAY_NONE || (overlay.lifetimeMillis > 0 && now - mOverlayStart[layer] >= overlay.lifetimeMillis);
+}
+
+uint8_t LEDDriver::showOverlay(const Overlay &overlay)
+{
+    unsigned long now = millis();
+    uint8_t layer = LAYER_EFFECT_GLITTER + 1;
+
+    for (uint8_t i = LAYER_EFFECT_GLITTER + 1; i < LED_NUM_LAYERS; i++) {
+        if (isOverlayFinished(i, now)) {
+            layer = i;
+            break;
+        }
+        if (now - mOverlayStart[i] > now - mOverlayStart[layer]) {
+            layer = i;
+        }
+    }
+
+    mOverlays[layer] = overlay;
+    mOverlaySerial[layer]++;
+    mOverlayStart[layer] = now;
+    publishRenderState();
+
+    return layer;
+}
+
+void LEDDriver::updateOverlay(uint8_t layer, uint8_t param)
+{
+    if (layer == LAYER_EFFECT_GLITTER || layer >= LED_NUM_LAYERS || mOverlays[layer].param == param) {
+        return;
+    }
+    mOverlays[layer].param = param;
+    publishRenderState();
+}
+
+void LEDDriver::clearOverlay(uint8_t layer)
+{
+    if (layer == LAYER_EFFECT_GLITTER || layer >= LED_NUM_LAYERS || mOverlays[layer].type == OVERLAY_NONE) {
+        return;
+    }
+    mOverlays[layer].type = OVERLAY_NONE;
+    mOverlaySerial[layer]++;
+    publishRenderState();
+}
+
+void LEDDriver::notify(NotifyAnimation animation, const CRGB &color, uint8_t count)
+{
+    if (mNotifyCount == LED_NOTIFY_QUEUE_LENGTH) {
+        Serial.printf("[LED] Notification queue full, dropping %s\n", NOTIFY_ANIMATIONS[animation]);
+        return;
+    }
+
+    // Covers the effect in the notification color
+    Overlay &overlay = mNotifyQueue[(mNotifyHead + mNotifyCount) % LED_NOTIFY_QUEUE_LENGTH];
+    overlay.blend = BLEND_ALPHA;
+    overlay.color = color;
+    overlay.alpha = 255;
+    overlay.param = 1;
+
+    switch (animation) {
+        case NOTIFY_PULSE:
+            overlay.type = OVERLAY_FLASH;
+            overlay.lifetimeMillis = NOTIFY_PULSE_MS;
+            break;
+        case NOTIFY_SWEEP:
+            overlay.type = OVERLAY_SWEEP;
+            overlay.lifetimeMillis = NOTIFY_SWEEP_MS;
+            break;
+        case NOTIFY_BLINK:
+            overlay.type = OVERLAY_BLINK;
+            overlay.param = count;
+            overlay.lifetimeMillis = count * NOTIFY_BLINK_MS;
+            break;
+    }
+    mNotifyCount++;
+
+    updateNotifications();
+}
+
+void LEDDriver::updateNotifications()
+{
+    if (mNotifyLayer < LED_NUM_LAYERS) {
+        // Replaced by another overlay or expired
+        if (mOverlaySerial[mNotifyLayer] == mNotifySerial && !isOverlayFinished(mNotifyLayer, millis())) {
+            return;
+        }
+        mNotifyLayer = LED_NUM_LAYERS;
+    }
+    if (mNotifyCount == 0) {
+        return;
+    }
+
+    mNotifyLayer = showOverlay(mNotifyQueue[mNotifyHead]);
+    mNotifySerial = mOverlaySerial[mNotifyLayer];
+    mNotifyHead = (mNotifyHead + 1) % LED_NOTIFY_QUEUE_LENGTH;
+    mNotifyCount--;
+}
+
 void LEDDriver::begin()
 {
     using namespace std::placeholders;
 
-    analogWriteFrequency(5000);
-    analogWriteResolution(8);
+    analogWriteFrequency(LAMP_PWM_FREQUENCY);
+    analogWriteResolution(LAMP_PWM_BITS);
 
-    pinMode(PIN_RGB_DATA, OUTPUT);
+    for (uint8_t i = 0; i < mOutput.numSegments(); i++) {
+        pinMode(mOutput.segment(i).pin, OUTPUT);
+    }
     pinMode(PIN_RGB_PWR, OUTPUT);
 
     digitalWrite(PIN_RGB_PWR, LOW);
 
-    FastLED.addLeds<WS2815, PIN_RGB_DATA, GRB>(mLEDs, NUM_LEDS).setCorrection( TypicalLEDStrip );
-    FastLED.setDither(BINARY_DITHER);
+    mOutput.begin(mFrameBuffer[0]);
+    mOutput.setCorrection(STRIP_CORRECTION);
+    mOutput.setDither(BINARY_DITHER);
 
     mLightIntensity = mSettings.intensity();
     mDimmedIntensity = mSettings.dimmedIntensity();
@@ -623,21 +1218,37 @@ void LEDDriver::begin()
 
     mHSV = mSettings.getHSV();
 
+    mDitherEnabled = mSettings.isDitherEnabled();
+    mRampMillis = mSettings.rampTime();
+
+    // The first frame advances the animations by one frame period, not by the time since boot
+    mLastFrameTime = millis();
+    mStatsStart = mLastFrameTime;
+
     enableLamps( mSettings.isLampEnabled(), false );
     enableLEDStrip( mSettings.isLEDStripEnabled(), false );
 
+    // Publishes the initial render state, the lamps fade in from off
     updateLamps();
-    updateLEDs();
 
     auto callback = std::bind(&LEDDriver::mqttCallback, this, _1, _2, _3);
     auto subscribeCallback = std::bind(&LEDDriver::subscribeCallback, this);
 
     mMqttClient.registerClient(MQS_LEDS, callback, subscribeCallback);
+
+#ifdef LED_RENDER_TASK
+    xTaskCreatePinnedToCore(renderTask, "render", RENDER_TASK_STACK, this, RENDER_TASK_PRIORITY,
+                            &mRenderTask, RENDER_TASK_CORE);
+#endif
 }
 
 void LEDDriver::loop()
 {
-    EVERY_N_MILLISECONDS( 20 ) {
-        updateAnimation();
+    updateNotifications();
+
+#ifndef LED_RENDER_TASK
+    if (millis() - mLastFrameTime >= mFramePeriod) {
+        renderFrame();
     }
+#endif
 }
@@ -12,74 +12,82 @@
 
 #include <inttypes.h>
 
+#include "LEDOutput.h"
+
 #include <FastLED.h>
 #include <chsv.h>
 #include <crgb.h>
 
 #include <commands.h>
 
+#include "config.h"
 #include "Settings.h"
 #include "MqttClient.h"
+#include "Snapshot.h"
+#include "PhaseAccumulator.h"
+#include "Effects.h"
+#include "RealtimeInput.h"
+#include "BeatInput.h"
+#include "BeatClock.h"
+#include "AudioInput.h"
+#include "AudioSpectrum.h"
+#include "TemporalDither.h"
+#include "PixelBlend.h"
+#include "ValueRamp.h"
+#include "LampCurve.h"
+#include "Compositor.h"
 
 static const uint8_t NUM_LAMPS = 2;
 
+class LoopProfiler;
+
 static const uint8_t LED_LAMP1 = 0;
 static const uint8_t LED_LAMP2 = 1;
 
-static const uint8_t NUM_LEDS = 108*2+8;
+enum NotifyAnimation : uint8_t {
+    // Fade the color in and out once
+    NOTIFY_PULSE,
+    // Band of the color crossing the room
+    NOTIFY_SWEEP,
+    // Switch the color on and off a number of times
+    NOTIFY_BLINK
+};
 
-static const uint8_t NUM_LEDS_CENTER = 8;
+bool parseNotifyAnimation(const char *str, NotifyAnimation &animation);
+
+/**
+ * Parse a color given as #rrggbb.
+ */
+bool parseHexColor(const char *str, CRGB &color);
 
 class LEDDriver {
     private:
-        enum LEDAnimation {
-            // No next animation scheduled
-            ANIM_NONE,
-            // Turn power off
-            ANIM_DISABLED,
-            // All LEDS same color, no animation
-            ANIM_ON,
-            // All LEDs same color, cycle color
-            ANIM_COLORCYCLE,
-            // Transition: Fade bar in; param = size of bar
-            ANIM_FADE_BAR_IN,
-            // Transition: Fade bar out; param = size of bar
-            ANIM_FADE_BAR_OUT,
-            // Show a bar; param = size of bar (number of leds)
-            ANIM_BAR,
-            // Show a single dot; param = position (pixel number)
-            ANIM_CIRCLE,
-            // Show a dot on both sides; param = position (pixel)
-            ANIM_SCAN,
-            // Fire animation; param = frame
-            ANIM_FIRE,
-            // Juggle animation
-            ANIM_JUGGLE,
-            // BPM animation
-            ANIM_BPM,
-            // rainbow animation
-            ANIM_RAINBOW,
-            // water animation
-            ANIM_WATER
+        /**
+         * Settings passed from the control side to the renderer.
+         */
+        struct RenderState {
+            bool    stripEnabled;
+            RGBMode mode;
+            CHSV    hsv;
+            uint8_t dimmedIntensity;
+            bool    dither;
+            uint32_t transitionMillis;
+            uint16_t rampMillis;
+            uint8_t  lampIntensity[NUM_LAMPS];
+            // Overlays by layer, restarted when the serial changes
+            Overlay  overlays[LED_NUM_LAYERS];
+            uint8_t  overlaySerial[LED_NUM_LAYERS];
+            // Tempo in 1/256 BPM, and the time of the last tap, synchronized when the serial changes
+            uint16_t bpm;
+            uint8_t  beatSerial;
+            unsigned long beatMillis;
         };
 
-        enum LEDEffect {
-            // fill all with same color
-            EF_FILLED,
-            // show a bar; param = size of bar
-            EF_BAR,
-            // show a single dot; param = position
-            EF_DOT,
-            // Show fire animation
-            EF_FIRE,
-            // Juggle animation; param = number of dots
-            EF_JUGGLE,
-            // BPM animation; param = 
-            EF_BPM,
-            // fill rainbow 
-            EF_RAINBOW,
-            // water animation
-            EF_WATER
+        /**
+         * Realtime frame passed from the loop task to the renderer.
+         */
+        struct StreamFrame {
+            CRGB    pixels[NUM_LEDS];
         };
 
         enum LEDFadeEffect {
@@ -93,11 +101,13 @@ class LEDDriver {
 
         Settings   &mSettings;
         MqttClient &mMqttClient;
+        LEDOutput  &mOutput;
+
+        /* Control state, owned by the loop task */
 
         CHSV    mHSV;
     
         uint8_t mIntensity[NUM_LAMPS];
-        CRGB    mLEDs[NUM_LEDS];
 
         bool    mEnableLamps = false;
         bool    mEnableLEDStrip = false;
@@ -107,43 +117,281 @@ class LEDDriver {
 
         RGBMode mRGBMode = RGB_ON;
 
-        LEDAnimation  mAnimation = ANIM_NONE;
-        LEDAnimation  mNextAnimation = ANIM_NONE;
-        bool          mAnimationDirection;
+        bool    mDitherEnabled = false;
+
+        uint32_t mTransitionMillis = LED_TRANSITION_MS;
+
+        // Time to ease color and intensity changes over
+        uint16_t mRampMillis = LED_RAMP_MS;
+
+        // Overlays requested by layer, the effect glitter layer is not used
+        Overlay       mOverlays[LED_NUM_LAYERS];
+        uint8_t       mOverlaySerial[LED_NUM_LAYERS];
+        unsigned long mOverlayStart[LED_NUM_LAYERS];
+
+        // Notifications waiting for the one being shown
+        Overlay       mNotifyQueue[LED_NOTIFY_QUEUE_LENGTH];
+        uint8_t       mNotifyHead = 0;
+        uint8_t       mNotifyCount = 0;
+        // Layer and serial of the notification being shown, LED_NUM_LAYERS if none
+        uint8_t       mNotifyLayer = LED_NUM_LAYERS;
+        uint8_t       mNotifySerial = 0;
+
+        // Tempo of the beat driven effects, in 1/256 BPM
+        uint16_t      mBPM = LED_DEFAULT_BPM << 8;
+        // Taps of the current tempo measurement
+        uint8_t       mTapCount = 0;
+        unsigned long mFirstTap = 0;
+        unsigned long mLastTap = 0;
+        // Beat falls on the last tap
+        unsigned long mBeatMillis = 0;
+        uint8_t       mBeatSerial = 0;
+
+        Snapshot<RenderState> mRenderState;
+
+        Snapshot<StreamFrame> mStreamFrame;
+
+        /* Render state, owned by the render task */
+
+        // Front buffer is being sent out, effects draw into the back buffer mLEDs.
+        // Word aligned for the packed pixel kernels.
+        alignas(4) CRGB mFrameBuffer[2][NUM_LEDS];
+        CRGB   *mLEDs = mFrameBuffer[0];
+
+        // Frames composed from mLEDs (crossfade, dithering) are sent from here, so that the effects
+        // keep drawing on their own pixels.
+        alignas(4) CRGB mOutputBuffer[2][NUM_LEDS];
+
+        // Buffer which has been sent out last, nullptr if the strip contents are unknown
+        const CRGB   *mShownFrame = nullptr;
+
+        // Last state received from the control side
+        RenderState mApplied;
+        // Time of the last rendered frame
+        unsigned long mLastFrameTime = 0;
+        // Time elapsed since the previous frame
+        uint32_t      mFrameDelta = LED_FRAME_PERIOD_MS;
+        // Time until the next frame, adapted to the current animation
+        uint32_t      mFramePeriod = LED_FRAME_PERIOD_MS;
+
+        // Brightness to send the next frame with
+        uint8_t       mBrightness = 0;
+        // Brightness the last frame was sent out with
+        uint8_t       mShownBrightness = 0;
+        // Send out the next frame even if it did not change
+        bool          mForceShow = true;
+        // Running average of the show() duration
+        uint32_t      mShowMicros = 0;
+
+        // Frame rate statistics
+        unsigned long mStatsStart = 0;
+        uint16_t      mRenderCount = 0;
+        uint16_t      mShowCount = 0;
+        uint16_t      mRenderRate = 0;
+        uint16_t      mShowRate = 0;
+
+        PhaseAccumulator mFadePhase;
+
+#ifdef LED_RENDER_TASK
+        TaskHandle_t mRenderTask = nullptr;
+
+        // Records the render time of each frame, if set
+        LoopProfiler *mProfiler = nullptr;
+
+        static void renderTask(void *param);
+#endif
+
+        // Current effect, nullptr if the strip is off
+        const EffectInfo *mEffect = nullptr;
+        // Effect to start after the current fade has finished
+        const EffectInfo *mNextEffect = nullptr;
+        // Turn the strip power off after the current fade has finished
+        bool          mPowerOffPending = false;
+
+        EffectContext mEffectContext;
+
+        // Color and dimmed intensity ease toward the last state received
+        ValueRamp     mHueRamp = ValueRamp(true);
+        ValueRamp     mSaturationRamp;
+        ValueRamp     mValueRamp;
+        ValueRamp     mDimmedRamp;
+
+        // Lamp outputs ease toward the lamp intensities
+        ValueRamp     mLampRamp[NUM_LAMPS];
+        // Duty cycles last written to the lamp outputs, LAMP_PWM_UNKNOWN before the first write
+        uint16_t      mLampDuty[NUM_LAMPS];
+
+        // Effect faded out by the crossfade, nullptr if only its last frame is blended
+        const EffectInfo *mOutgoingEffect = nullptr;
+        EffectContext mOutgoingContext;
+        alignas(4) CRGB mOutgoingLEDs[NUM_LEDS];
+        bool          mOutgoingDimmed = false;
+
+        bool          mCrossfading = false;
+        uint32_t      mCrossfadeElapsed = 0;
+        uint32_t      mCrossfadeDuration = 0;
+
+        // Frames streamed over the network, replace the current effect while active
+        RealtimeInput mRealtime;
+
+        // External beat clock, takes over the tempo and beat position while packets arrive
+        BeatInput     mBeatInput;
+        // Beat of the effects, copied into the effect contexts every frame
+        BeatClock     mBeat;
+        // Move the beat onto the last tap in the next frame
+        bool          mTapSyncPending = false;
+
+        // Audio spectrum frames of the audio reactive effects
+        AudioInput    mAudioInput;
+        // Audio levels, copied into the effect contexts every frame
+        AudioSpectrum mAudio;
+
+        // Overlays drawn above the effect or the realtime frame
+        Compositor    mCompositor;
+
+        // High-precision output stage
+        TemporalDither mDither;
+        // Dithered output changes from frame to frame
+        bool          mDitherResidual = false;
 
         LEDFadeEffect mFadeEffect;
         int           mFadeParam;
 
-        LEDEffect     mEffect;
-        int           mEffectParam;
-        int           mEffectCount;
-        // Mirror the effect on both sides, otherwise use the full length
-        bool          mEffectMirrored = false;
-        CRGBPalette16 mEffectPalette;
-        // BPM value for some effects
-        int           mEffectBPM = 13;
-        // Speed to fade out old pixels
-        int           mFadeSpeed = 20;
-        // Add some glitter effect; 0 = off, 255: full
-        int           mGlitterChance = 0;
-
         void updateLamps();
 
-        void updateLEDs();
+        /**
+         * Move the lamps along their ramps and write the changed duty cycles, once per frame.
+         */
+        void updateLampOutputs(uint32_t dt);
+
+        /**
+         * Move the effect color along the ramps.
+         */
+        void updateRamps(uint32_t dt);
+
+        /**
+         * Render the current effect and send out the frame.
+         */
+        void updateLEDs(uint32_t dt);
+
+        /**
+         * Advance an effect and render it into the full strip, with the strip fade mask applied.
+         */
+        void renderEffect(const EffectInfo *effect, EffectContext &ctx, CRGB *leds, uint32_t dt);
+
+        /**
+         * Black out the pixels the strip fade has not reached, on the first length pixels.
+         * A length below NUM_LEDS masks the rendered half of a mirrored effect.
+         */
+        void applyFadeMask(CRGB *leds, int length);
+
+        /**
+         * Apply the crossfade, overlays, strip fade and brightness to the rendered pixels and send out the frame.
+         *
+         * @param masked: the pixels have been rendered by renderEffect() with the fade mask applied.
+         */
+        void finishFrame(bool masked = false);
+
+        /**
+         * Glitter chance of the effects, blended while crossfading.
+         */
+        uint8_t effectGlitterChance() const;
+
+        /**
+         * Check if an overlay layer can be reused, because it is empty or has expired.
+         */
+        bool isOverlayFinished(uint8_t layer, unsigned long now) const;
+
+        /**
+         * Show the next queued notification once the current one has finished.
+         */
+        void updateNotifications();
+
+        /**
+         * Brightness of a mode as 16 bit level.
+         */
+        uint32_t brightnessLevel(bool dimmed) const;
+
+        /**
+         * Eased share of the incoming effect in the crossfade.
+         */
+        uint8_t crossfadeAmount() const;
+
+        /**
+         * Receive realtime frames from the network and the loop task into the back buffer.
+         *
+         * @return true if the realtime input replaces the current effect.
+         */
+        bool updateRealtime();
+
+        /**
+         * Receive the external beat clock and advance the beat of the effects.
+         */
+        void updateBeat(uint32_t dt);
+
+        /**
+         * Receive the audio spectrum and decay the audio levels.
+         */
+        void updateAudio(uint32_t dt);
+
+        /**
+         * Send out the back buffer, unless it is identical to the last frame sent.
+         */
+        void showFrame();
+
+        /**
+         * Output buffer which is not being sent out.
+         */
+        CRGB *nextOutputBuffer();
+
+        /**
+         * Quantize the pixels with a 16 bit brightness level into the output buffer and send it out.
+         */
+        void showDithered(const CRGB *pixels, CRGB *output, uint32_t level);
+
+        /**
+         * Send out a frame unless it is identical to the frame shown before.
+         *
+         * @return true if the frame was sent.
+         */
+        bool sendFrame(CRGB *front);
+
+        /**
+         * Check if the current animation produces the same frame until the state changes.
+         */
+        bool isStaticAnimation() const;
+
+        uint32_t nextFramePeriod() const;
 
-        void updateAnimation();
+        void updateFrameStats();
 
-        LEDAnimation getAnimation(RGBMode mode);
+        /**
+         * Advance the strip fade by the given time in milliseconds and switch effects when it is finished.
+         */
+        void updateTransition(uint32_t dt);
 
-        void setNextAnimation(LEDAnimation animation);
+        void publishRenderState();
 
-        void startAnimation(LEDAnimation animation);
+        void applyRenderState(const RenderState &state);
 
-        void startFading(bool fadeOut, LEDAnimation nextAnimation);
+        /**
+         * Render and send out one frame.
+         */
+        void renderFrame();
 
-        bool isFadeAnimation() const { return mAnimation == ANIM_FADE_BAR_IN || mAnimation == ANIM_FADE_BAR_OUT; }
+        /**
+         * Effect of an RGB mode, falls back to the plain color for unknown modes.
+         */
+        static const EffectInfo *getEffect(RGBMode mode);
 
-        bool isAnimationFinished() const;
+        void startEffect(const EffectInfo *effect);
+
+        /**
+         * Blend from the current effect to the given effect over the transition time.
+         */
+        void startCrossfade(const EffectInfo *effect);
+
+        void startFading(bool fadeOut, const EffectInfo *nextEffect);
 
         void mqttCallback(const char *key, const char* payload, unsigned int length);
 
@@ -151,10 +399,14 @@ class LEDDriver {
 
         void publishColor(bool subscribe = false);
 
+        void publishTransition(bool subscribe = false);
+
+        void publishBPM(bool subscribe = false);
+
         void appendHexCode(String &rgb, uint8_t val);
 
     public:
-        explicit LEDDriver(Settings &settings, MqttClient &mqttClient);
+        explicit LEDDriver(Settings &settings, MqttClient &mqttClient, LEDOutput &output);
 
 
         bool    isLampEnabled() { return mEnableLamps; }
@@ -168,9 +420,42 @@ class LEDDriver {
 
         RGBMode rgbMode() const { return mRGBMode; }
 
+        bool    isDitherEnabled() const { return mDitherEnabled; }
+
+        uint32_t transition() const { return mTransitionMillis; }
+
         const CHSV &getHSV() const { return mHSV; }
 
 
+        /**
+         * Number of frames sent to the strip in the last second.
+         */
+        uint16_t frameRate() const { return mShowRate; }
+
+        /**
+         * Number of frames rendered in the last second, including unchanged frames which were not sent.
+         */
+        uint16_t renderRate() const { return mRenderRate; }
+
+        uint32_t showMicros() const { return mShowMicros; }
+
+        /**
+         * Frame period of dynamic effects for the given time to send a frame, between LED_MIN_FRAME_PERIOD_MS
+         * and LED_MAX_FRAME_PERIOD_MS.
+         */
+        static uint32_t adaptiveFramePeriod(uint32_t showMicros);
+
+        const RealtimeInput &realtimeInput() const { return mRealtime; }
+
+        const BeatInput &beatInput() const { return mBeatInput; }
+
+        const BeatClock &beatClock() const { return mBeat; }
+
+        const AudioInput &audioInput() const { return mAudioInput; }
+
+        const AudioSpectrum &audioSpectrum() const { return mAudio; }
+
+
         void enableLamps(bool enabled, bool publish = true);
 
         void enableLEDStrip(bool enabled, bool publish = true);
@@ -182,10 +467,77 @@ class LEDDriver {
 
         void setRGBMode(RGBMode mode, bool publish = true);
 
+        /**
+         * Set the duration of the crossfade between effects, 0 switches immediately.
+         */
+        void setTransition(uint32_t millis, bool publish = true);
+
+        /**
+         * Set the time over which color and intensity changes are eased, 0 applies them immediately.
+         */
+        void setRampTime(uint16_t millis);
+
+        uint16_t rampTime() const { return mRampMillis; }
+
+        /**
+         * Set the tempo of the beat driven effects in 1/256 BPM, without restarting their beat.
+         */
+        void setBPM(uint16_t bpm, bool publish = true);
+
+        uint16_t bpm() const { return mBPM; }
+
+        /**
+         * Tap the beat: consecutive taps set the tempo from their average interval, every tap moves the beat onto it.
+         */
+        void tapTempo();
+
+        /**
+         * Enable the high-precision output with temporal dithering, for smooth fades at low brightness.
+         */
+        void enableDither(bool enabled);
+
         void setHSV(CHSV hsv, bool publish = true);
 
         void setHSV(uint8_t hue, uint8_t saturation, uint8_t value, bool publish = true);
 
+        /**
+         * Show an overlay above the current effect, which keeps running below it.
+         * Takes a free layer, or replaces the overlay shown the longest if all layers are in use.
+         *
+         * @return the layer of the overlay, to update or clear it.
+         */
+        uint8_t showOverlay(const Overlay &overlay);
+
+        /**
+         * Change the parameter of a shown overlay, such as the progress, without restarting it.
+         */
+        void updateOverlay(uint8_t layer, uint8_t param);
+
+        void clearOverlay(uint8_t layer);
+
+        /**
+         * Queue a notification, shown above the current effect after the notifications before it.
+         *
+         * @param count: number of blinks, the other animations are shown once.
+         */
+        void notify(NotifyAnimation animation, const CRGB &color, uint8_t count = 1);
+
+        /**
+         * Buffer for the next realtime frame received by the loop task.
+         * Fill all pixels, then pass it to the renderer with publishStreamFrame().
+         */
+        CRGB *streamFrameBuffer() { return mStreamFrame.writeBuffer().pixels; }
+
+        void publishStreamFrame() { mStreamFrame.publish(); }
+
+#ifdef LED_RENDER_TASK
+        /**
+         * Record the render time of the frames in the PROF_LEDS slot of the profiler, from the render task.
+         * Must be set before begin().
+         */
+        void setProfiler(LoopProfiler *profiler) { mProfiler = profiler; }
+#endif
+
         /**
          * Initialize all input ports and routines.
          **/
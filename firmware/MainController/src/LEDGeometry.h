@@ -0,0 +1,199 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Position of every pixel in the room, generated at compile time from the strip layout.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <FastLED.h>
+
+#include "config.h"
+
+/**
+ * Position of a pixel, all values scaled to 8 bit.
+ */
+struct PixelCoord
+{
+    // Position in the room, both axes scaled alike so that the longer side spans 0 to 255
+    uint8_t x;
+    uint8_t y;
+    // Direction from the room center, 0 to 255 for a full turn, 0 pointing along the x axis
+    uint8_t angle;
+    // Distance from the room center, 255 for the farthest pixel
+    uint8_t distance;
+};
+
+namespace geometry {
+
+    static constexpr double PI_D = 3.14159265358979323846;
+
+    constexpr double square(double v) { return v * v; }
+
+    constexpr double absolute(double v) { return v < 0 ? -v : v; }
+
+    constexpr double sqrtStep(double v, double guess, int steps)
+    {
+        return steps == 0 ? guess : sqrtStep(v, 0.5 * (guess + v / guess), steps - 1);
+    }
+
+    constexpr double squareRoot(double v)
+    {
+        return v <= 0 ? 0 : sqrtStep(v, v > 1 ? v : 1, 40);
+    }
+
+    /**
+     * Arc tangent for |z| <= 1, within 0.002 radians, well below one 8 bit angle step.
+     */
+    constexpr double atanUnit(double z)
+    {
+        return PI_D / 4 * z - z * (absolute(z) - 1) * (0.2447 + 0.0663 * absolute(z));
+    }
+
+    constexpr double atanFirstQuadrant(double y, double x)
+    {
+        return x >= y ? (x == 0 ? 0 : atanUnit(y / x)) : PI_D / 2 - atanUnit(x / y);
+    }
+
+    constexpr double atanHalf(double y, double x)
+    {
+        return x < 0 ? PI_D - atanFirstQuadrant(absolute(y), -x) : atanFirstQuadrant(absolute(y), x);
+    }
+
+    /**
+     * Angle of the vector (x, y) in 0 to 2 pi.
+     */
+    constexpr double angle(double y, double x)
+    {
+        return y < 0 ? 2 * PI_D - atanHalf(y, x) : atanHalf(y, x);
+    }
+
+    constexpr uint8_t toByte(double v)
+    {
+        return v <= 0 ? 0 : (v >= 255 ? 255 : (uint8_t) (v + 0.5));
+    }
+
+    template<int... I> struct Indices {};
+
+    template<typename First, typename Second> struct Concat;
+
+    template<int... A, int... B> struct Concat< Indices<A...>, Indices<B...> >
+    {
+        typedef Indices<A..., (int) sizeof...(A) + B...> type;
+    };
+
+    // Split in halves, so that the template depth stays logarithmic for long strips
+    template<int N> struct MakeIndices
+        : Concat<typename MakeIndices<N / 2>::type, typename MakeIndices<N - N / 2>::type> {};
+
+    template<> struct MakeIndices<0> { typedef Indices<> type; };
+
+    template<> struct MakeIndices<1> { typedef Indices<0> type; };
+}
+
+/**
+ * Pixel positions of a strip layout.
+ *
+ * The two sides run parallel, joined by the center block across one end. Positions are in pixel
+ * pitches: the first side runs along y = 0 from its end at x = SIDE_LENGTH to x = 1, the center
+ * block along x = 0, and the second side back along y = CENTER_LENGTH + 1. The room center is the
+ * middle of that rectangle, so the distance and the y axis are symmetric between both halves.
+ */
+template<typename Layout>
+struct LEDGeometry
+{
+    static constexpr double WIDTH = Layout::SIDE_LENGTH;
+    static constexpr double HEIGHT = Layout::CENTER_LENGTH + 1;
+
+    static constexpr double SCALE = 255.0 / (WIDTH > HEIGHT ? WIDTH : HEIGHT);
+    static constexpr double MAX_DISTANCE = geometry::squareRoot(WIDTH * WIDTH + HEIGHT * HEIGHT) / 2;
+
+    static constexpr double rawX(int index)
+    {
+        return index < Layout::SIDE_LENGTH ? Layout::SIDE_LENGTH - index
+             : index < Layout::SIDE_LENGTH + Layout::CENTER_LENGTH ? 0
+             : index - Layout::SIDE_LENGTH - Layout::CENTER_LENGTH + 1;
+    }
+
+    static constexpr double rawY(int index)
+    {
+        return index < Layout::SIDE_LENGTH ? 0
+             : index < Layout::SIDE_LENGTH + Layout::CENTER_LENGTH ? index - Layout::SIDE_LENGTH + 1
+             : HEIGHT;
+    }
+
+    static constexpr PixelCoord coord(int index)
+    {
+        return PixelCoord{
+            // The shorter axis is centered in the 8 bit range
+            geometry::toByte(127.5 + (rawX(index) - WIDTH / 2) * SCALE),
+            geometry::toByte(127.5 + (rawY(index) - HEIGHT / 2) * SCALE),
+            (uint8_t) ((int) (geometry::angle(rawY(index) - HEIGHT / 2, rawX(index) - WIDTH / 2) * 128 / geometry::PI_D + 0.5) & 0xFF),
+            geometry::toByte(geometry::squareRoot(geometry::square(rawX(index) - WIDTH / 2) +
+                                                  geometry::square(rawY(index) - HEIGHT / 2)) * 255 / MAX_DISTANCE)
+        };
+    }
+
+    template<typename T> struct Table;
+
+    template<int... I> struct Table< geometry::Indices<I...> >
+    {
+        static constexpr PixelCoord values[sizeof...(I)] = { coord(I)... };
+    };
+
+    typedef Table< typename geometry::MakeIndices<Layout::NUM_LEDS>::type > Coords;
+
+    static const PixelCoord &at(uint16_t index) { return Coords::values[index]; }
+};
+
+template<typename Layout>
+template<int... I>
+constexpr PixelCoord LEDGeometry<Layout>::Table< geometry::Indices<I...> >::values[sizeof...(I)];
+
+typedef LEDGeometry<StripLayout> StripGeometry;
+
+/* ==================================================== */
+/* Spatial sampling helpers for the effects             */
+/* ==================================================== */
+
+/**
+ * Phase of a wave travelling outwards from the room center, for sin8() or a palette index.
+ *
+ * @param waves: number of wave crests between the center and the farthest pixel, in 4.4 fixed point.
+ * @param offset: moves the waves outwards as it increases.
+ */
+static inline uint8_t radialPhase(const PixelCoord &coord, uint8_t waves, uint8_t offset)
+{
+    return ((coord.distance * waves) >> 4) - offset;
+}
+
+/**
+ * Direction of a linear sweep across the room, so that sampling a pixel costs two multiplications.
+ */
+struct SweepAxis
+{
+    int8_t dx;
+    int8_t dy;
+
+    /**
+     * Sweep moving toward the given direction, 0 to 255 for a full turn, 0 along the x axis.
+     */
+    explicit SweepAxis(uint8_t direction)
+        : dx(cos16(direction << 8) >> 8), dy(sin16(direction << 8) >> 8) {}
+
+    /**
+     * Position of a pixel along the sweep, from 0 at the trailing edge of the room to 255 at the leading edge.
+     */
+    uint8_t position(const PixelCoord &coord) const
+    {
+        // Projection onto the direction, the diagonal of the 8 bit square stays within range
+        int32_t projected = (coord.x - 128) * dx + (coord.y - 128) * dy;
+        return 128 + (projected * 180 >> 15);
+    }
+};
@@ -0,0 +1,54 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Compile-time layout of the LED strip.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+/**
+ * Strip with two side segments of equal length and a center block between them.
+ *
+ * Pixels are indexed from the end of the first side, over the center block to the end of the second side.
+ * Mirrored effects render the first half, which includes half of the center block, and copy it in reverse
+ * onto the second half.
+ */
+template<uint16_t SideLength, uint16_t CenterLength>
+struct LEDLayout
+{
+    static const uint16_t SIDE_LENGTH = SideLength;
+    static const uint16_t CENTER_LENGTH = CenterLength;
+
+    static const uint16_t NUM_LEDS = SideLength * 2 + CenterLength;
+
+    // Length rendered by mirrored effects
+    static const uint16_t HALF_LENGTH = NUM_LEDS / 2;
+
+    static_assert(SideLength * 2UL + CenterLength <= 0xFFFF, "Pixels are indexed with 16 bit");
+    static_assert(CenterLength % 2 == 0, "The center block is split evenly between both halves");
+
+    /**
+     * Index of the pixel at the same position on the other half.
+     */
+    static uint16_t mirrorIndex(uint16_t index) { return NUM_LEDS - 1 - index; }
+
+    /**
+     * Copy the first half of the strip in reverse order onto the second half.
+     */
+    template<typename Pixel>
+    static void mirror(Pixel *leds)
+    {
+        const Pixel *src = leds;
+        Pixel *dst = leds + NUM_LEDS - 1;
+
+        while (src < dst) {
+            *dst-- = *src++;
+        }
+    }
+};
@@ -0,0 +1,134 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Output stage sending frames to the LED strip, split into segments with one data pin each.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <FastLED.h>
+
+#include "config.h"
+
+/**
+ * Consecutive pixels of the frame, sent on one data pin starting at the first pixel.
+ */
+struct OutputSegment
+{
+    uint8_t  pin;
+    uint16_t start;
+    uint16_t length;
+};
+
+/**
+ * Sends frames out on one or more data pins.
+ */
+class LEDOutput
+{
+    public:
+        virtual ~LEDOutput() {}
+
+        /**
+         * Set up the outputs, sending from the given frame until the first show().
+         */
+        virtual void begin(CRGB *frame) = 0;
+
+        virtual uint8_t numSegments() const = 0;
+
+        virtual const OutputSegment &segment(uint8_t index) const = 0;
+
+        virtual void setCorrection(const CRGB &correction) = 0;
+
+        virtual void setDither(uint8_t ditherMode) = 0;
+
+        /**
+         * Send a frame on all segments. The frame must not be modified until the next show().
+         */
+        virtual void show(CRGB *frame, uint8_t brightness) = 0;
+};
+
+/**
+ * Splits the strip evenly over the given data pins, one FastLED controller per pin.
+ *
+ * The ESP32 RMT driver (and the I2S driver, with FASTLED_ESP32_I2S defined in the build flags) starts
+ * all controllers before it waits for the first one, so the segments are sent in parallel and show()
+ * takes as long as the longest segment.
+ */
+template<uint8_t... Pins>
+class FastLEDOutput : public LEDOutput
+{
+    private:
+        static const uint8_t NUM_SEGMENTS = sizeof...(Pins);
+
+        OutputSegment mSegments[NUM_SEGMENTS];
+
+        // Index of the controller of the first segment
+        int mFirstController = 0;
+
+        int initSegment(uint8_t pin, uint8_t index)
+        {
+            OutputSegment &segment = mSegments[index];
+            segment.pin = pin;
+            segment.start = (uint32_t) NUM_LEDS * index / NUM_SEGMENTS;
+            segment.length = (uint32_t) NUM_LEDS * (index + 1) / NUM_SEGMENTS - segment.start;
+            return 0;
+        }
+
+        template<uint8_t Pin>
+        int addController(CRGB *frame, uint8_t index)
+        {
+            FastLED.addLeds<WS2815, Pin, GRB>(frame, mSegments[index].start, mSegments[index].length);
+            return 0;
+        }
+
+    public:
+        FastLEDOutput()
+        {
+            // Braced lists are evaluated in order, so the segments follow the pin order
+            uint8_t index = 0;
+            int segments[] = { initSegment(Pins, index++)... };
+            (void) segments;
+        }
+
+        virtual void begin(CRGB *frame)
+        {
+            mFirstController = FastLED.count();
+
+            uint8_t index = 0;
+            int controllers[] = { addController<Pins>(frame, index++)... };
+            (void) controllers;
+        }
+
+        virtual uint8_t numSegments() const { return NUM_SEGMENTS; }
+
+        virtual const OutputSegment &segment(uint8_t index) const { return mSegments[index]; }
+
+        virtual void setCorrection(const CRGB &correction)
+        {
+            for (uint8_t i = 0; i < NUM_SEGMENTS; i++) {
+                FastLED[mFirstController + i].setCorrection(correction);
+            }
+        }
+
+        virtual void setDither(uint8_t ditherMode) { FastLED.setDither(ditherMode); }
+
+        virtual void show(CRGB *frame, uint8_t brightness)
+        {
+            for (uint8_t i = 0; i < NUM_SEGMENTS; i++) {
+                FastLED[mFirstController + i].setLeds(frame + mSegments[i].start, mSegments[i].length);
+            }
+            FastLED.show(brightness);
+        }
+};
+
+#ifdef LED_PARALLEL_OUTPUT
+typedef FastLEDOutput<PIN_RGB_DATA, PIN_RGB_DATA2> StripOutput;
+#else
+typedef FastLEDOutput<PIN_RGB_DATA> StripOutput;
+#endif
@@ -0,0 +1,67 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * CIE 1931 lightness curve for the lamp PWM, generated at compile time.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include "config.h"
+
+namespace lampcurve {
+
+    /**
+     * Relative luminance for a lightness L* between 0 and 100.
+     */
+    constexpr double luminance(double lightness)
+    {
+        return lightness > 8.0
+             ? ((lightness + 16.0) / 116.0) * ((lightness + 16.0) / 116.0) * ((lightness + 16.0) / 116.0)
+             : lightness / 903.3;
+    }
+
+    constexpr uint16_t duty(int intensity)
+    {
+        return (uint16_t) (luminance(intensity * 100.0 / 255.0) * LAMP_PWM_MAX + 0.5);
+    }
+
+    template<int... I> struct Indices {};
+
+    template<int N, int... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+
+    template<int... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+
+    template<typename T> struct Table;
+
+    template<int... I> struct Table< Indices<I...> >
+    {
+        static constexpr uint16_t values[sizeof...(I)] = { duty(I)... };
+    };
+
+    template<int... I> constexpr uint16_t Table< Indices<I...> >::values[sizeof...(I)];
+
+    typedef Table< MakeIndices<256>::type > DutyTable;
+
+    static_assert(DutyTable::values[0] == 0 && DutyTable::values[255] == LAMP_PWM_MAX, "Lamp curve must span the PWM range");
+}
+
+/**
+ * PWM duty cycle for a lamp intensity in 8.8 fixed point, interpolated between the curve entries.
+ */
+static inline uint16_t lampDuty(uint16_t intensity)
+{
+    const uint16_t *table = lampcurve::DutyTable::values;
+
+    uint8_t index = intensity >> 8;
+    uint8_t fraction = intensity & 0xFF;
+    if (fraction == 0 || index == 255) {
+        return table[index];
+    }
+    return table[index] + (((uint32_t) (table[index + 1] - table[index]) * fraction) >> 8);
+}
@@ -0,0 +1,218 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Loop profiler implementation.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "LoopProfiler.h"
+
+#include <ArduinoJson.h>
+
+const char *TOPIC_PERF = "perf";
+
+LoopProfiler::LoopProfiler(Settings &settings, MqttClient &mqttClient, LEDDriver &leds)
+: mSettings(settings), mMqttClient(mqttClient), mLEDs(leds)
+{
+    mCyclesPerMicro = 240;
+    mOverrunCycles = LED_FRAME_PERIOD_MS * 1000 * mCyclesPerMicro;
+    reset();
+}
+
+const char *LoopProfiler::slotName(ProfileSlot slot)
+{
+    switch (slot) {
+        case PROF_KEYPAD:
+            return "keypad";
+        case PROF_CMDLINE:
+            return "cmdline";
+        case PROF_MQTT:
+            return "mqtt";
+        case PROF_LEDS:
+            return "leds";
+        case PROF_PROJECTOR:
+            return "projector";
+        case PROF_LOOP:
+            return "loop";
+        case NUM_PROFILE_SLOTS:
+            break;
+    }
+    return "";
+}
+
+uint8_t LoopProfiler::bucketIndex(uint32_t micros)
+{
+    if (micros < PROFILE_SUB_BUCKETS) {
+        return micros;
+    }
+    uint8_t exponent = 31 - __builtin_clz(micros);
+    uint8_t sub = (micros >> (exponent - 2)) & 0x03;
+    uint16_t bucket = exponent * PROFILE_SUB_BUCKETS + sub;
+
+    return bucket < PROFILE_NUM_BUCKETS ? bucket : PROFILE_NUM_BUCKETS - 1;
+}
+
+uint32_t LoopProfiler::bucketUpperBound(uint8_t bucket)
+{
+    if (bucket < PROFILE_SUB_BUCKETS) {
+        return bucket;
+    }
+    uint8_t exponent = bucket / PROFILE_SUB_BUCKETS;
+    uint8_t sub = bucket % PROFILE_SUB_BUCKETS;
+
+    return ((PROFILE_SUB_BUCKETS + sub + 1) << (exponent - 2)) - 1;
+}
+
+void LoopProfiler::start(ProfileSlot slot)
+{
+    mStartCycles[slot] = ESP.getCycleCount();
+}
+
+void LoopProfiler::stop(ProfileSlot slot)
+{
+    // unsigned arithmetic handles a single wrap of the cycle counter
+    uint32_t cycles = ESP.getCycleCount() - mStartCycles[slot];
+    SlotStats &stats = mStats[slot];
+
+    if (slot == PROF_LEDS && mFrameResetPending.exchange(false)) {
+        clearStats(stats);
+    }
+
+    stats.count++;
+    stats.totalCycles += cycles;
+    if (cycles < stats.minCycles) {
+        stats.minCycles = cycles;
+    }
+    if (cycles > stats.maxCycles) {
+        stats.maxCycles = cycles;
+    }
+    if (cycles > mOverrunCycles) {
+        stats.overruns++;
+    }
+    stats.histogram[bucketIndex(toMicros(cycles))]++;
+
+    if (slot == PROF_LEDS) {
+        mFrameStats.publish(stats);
+    }
+}
+
+void LoopProfiler::clearStats(SlotStats &stats)
+{
+    stats.count = 0;
+    stats.minCycles = UINT32_MAX;
+    stats.maxCycles = 0;
+    stats.totalCycles = 0;
+    stats.overruns = 0;
+    for (uint8_t b = 0; b < PROFILE_NUM_BUCKETS; b++) {
+        stats.histogram[b] = 0;
+    }
+}
+
+void LoopProfiler::reset()
+{
+    for (uint8_t i = 0; i < NUM_PROFILE_SLOTS; i++) {
+        if (i != PROF_LEDS) {
+            clearStats(mStats[i]);
+        }
+    }
+    mFrameResetPending = true;
+}
+
+uint32_t LoopProfiler::minMicros(ProfileSlot slot) const
+{
+    const SlotStats &data = stats(slot);
+    return data.count > 0 ? toMicros(data.minCycles) : 0;
+}
+
+uint32_t LoopProfiler::avgMicros(ProfileSlot slot) const
+{
+    const SlotStats &data = stats(slot);
+    return data.count > 0 ? toMicros(data.totalCycles / data.count) : 0;
+}
+
+uint32_t LoopProfiler::percentileMicros(ProfileSlot slot, uint8_t percentile) const
+{
+    const SlotStats &data = stats(slot);
+    if (data.count == 0) {
+        return 0;
+    }
+
+    // Number of samples that must be at or below the result
+    uint32_t target = ((uint64_t) data.count * percentile + 99) / 100;
+    uint32_t seen = 0;
+
+    for (uint8_t b = 0; b < PROFILE_NUM_BUCKETS; b++) {
+        seen += data.histogram[b];
+        if (seen >= target) {
+            return bucketUpperBound(b);
+        }
+    }
+    return maxMicros(slot);
+}
+
+void LoopProfiler::printStats()
+{
+    mFrameStats.update();
+
+    Serial.printf("%-10s %8s %8s %8s %8s %8s %8s\n", "module", "count", "min", "avg", "p99", "max", "overrun");
+    for (uint8_t i = 0; i < NUM_PROFILE_SLOTS; i++) {
+        ProfileSlot slot = (ProfileSlot) i;
+        Serial.printf("%-10s %8u %8u %8u %8u %8u %8u\n", slotName(slot), count(slot),
+                      minMicros(slot), avgMicros(slot), percentileMicros(slot, 99), maxMicros(slot), overruns(slot));
+    }
+    Serial.printf("LED frames: %hu fps sent, %hu fps rendered, show %u us\n",
+                  mLEDs.frameRate(), mLEDs.renderRate(), mLEDs.showMicros());
+    Serial.println("Times in us.");
+}
+
+void LoopProfiler::publishTelemetry()
+{
+    mFrameStats.update();
+
+    JsonDocument doc;
+
+    for (uint8_t i = 0; i < NUM_PROFILE_SLOTS; i++) {
+        ProfileSlot slot = (ProfileSlot) i;
+        JsonObject module = doc[slotName(slot)].to<JsonObject>();
+        module["avg"] = avgMicros(slot);
+        module["p99"] = percentileMicros(slot, 99);
+        module["max"] = maxMicros(slot);
+        module["overruns"] = overruns(slot);
+    }
+
+    JsonObject frames = doc["frames"].to<JsonObject>();
+    frames["fps"] = mLEDs.frameRate();
+    frames["render"] = mLEDs.renderRate();
+    frames["show"] = mLEDs.showMicros();
+
+    String json;
+    serializeJson(doc, json);
+    mMqttClient.publish(MQS_SYSTEM, TOPIC_PERF, json.c_str());
+}
+
+void LoopProfiler::setTelemetryInterval(uint16_t seconds)
+{
+    mTelemetryInterval = seconds;
+    mSettings.setPerfTelemetryInterval(seconds);
+}
+
+void LoopProfiler::begin()
+{
+    mCyclesPerMicro = ESP.getCpuFreqMHz();
+    mOverrunCycles = LED_FRAME_PERIOD_MS * 1000 * mCyclesPerMicro;
+    mTelemetryInterval = mSettings.perfTelemetryInterval();
+}
+
+void LoopProfiler::loop()
+{
+    if (mTelemetryInterval == 0 || !mMqttClient.connected()) {
+        return;
+    }
+    if (millis() - mLastTelemetry >= (unsigned long) mTelemetryInterval * 1000) {
+        mLastTelemetry = millis();
+        publishTelemetry();
+    }
+}
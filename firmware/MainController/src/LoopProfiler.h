@@ -0,0 +1,123 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Cycle-counter based runtime statistics for the modules called from loop() and for the LED frames.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <atomic>
+
+#include "Snapshot.h"
+#include "Settings.h"
+#include "MqttClient.h"
+#include "LED.h"
+
+enum ProfileSlot : uint8_t {
+    PROF_KEYPAD,
+    PROF_CMDLINE,
+    PROF_MQTT,
+    // LED frames, recorded by the render task instead of loop() and read through a snapshot
+    PROF_LEDS,
+    PROF_PROJECTOR,
+    // Complete loop() iteration
+    PROF_LOOP,
+    NUM_PROFILE_SLOTS
+};
+
+// Histogram buckets: 4 sub-buckets per power of two microseconds, up to ~1s.
+static const uint8_t PROFILE_SUB_BUCKETS = 4;
+static const uint8_t PROFILE_NUM_BUCKETS = 21 * PROFILE_SUB_BUCKETS;
+
+class LoopProfiler
+{
+    private:
+        struct SlotStats {
+            uint32_t count;
+            uint32_t minCycles;
+            uint32_t maxCycles;
+            uint64_t totalCycles;
+            // Number of runs longer than the LED frame period
+            uint32_t overruns;
+            uint32_t histogram[PROFILE_NUM_BUCKETS];
+        };
+
+        Settings   &mSettings;
+        MqttClient &mMqttClient;
+        LEDDriver  &mLEDs;
+
+        SlotStats mStats[NUM_PROFILE_SLOTS];
+        uint32_t  mStartCycles[NUM_PROFILE_SLOTS];
+
+        // Copy of the PROF_LEDS slot, published by the render task after each frame
+        Snapshot<SlotStats> mFrameStats;
+        // The render task clears its slot on the next frame, loop() never writes it
+        std::atomic<bool>   mFrameResetPending{true};
+
+        uint32_t  mCyclesPerMicro;
+        uint32_t  mOverrunCycles;
+
+        // Telemetry publish interval in seconds, 0 = disabled
+        uint16_t      mTelemetryInterval = 0;
+        unsigned long mLastTelemetry = 0;
+
+        static uint8_t bucketIndex(uint32_t micros);
+
+        static void clearStats(SlotStats &stats);
+
+        /**
+         * Statistics of the slot for the reader, the latest snapshot for PROF_LEDS.
+         */
+        const SlotStats &stats(ProfileSlot slot) const { return slot == PROF_LEDS ? mFrameStats.read() : mStats[slot]; }
+
+        static uint32_t bucketUpperBound(uint8_t bucket);
+
+        uint32_t toMicros(uint64_t cycles) const { return cycles / mCyclesPerMicro; }
+
+        void publishTelemetry();
+
+    public:
+        explicit LoopProfiler(Settings &settings, MqttClient &mqttClient, LEDDriver &leds);
+
+        static const char *slotName(ProfileSlot slot);
+
+        void start(ProfileSlot slot);
+
+        void stop(ProfileSlot slot);
+
+        /**
+         * Clear all statistics. The frame statistics are cleared by the render task with its next frame.
+         */
+        void reset();
+
+        uint32_t count(ProfileSlot slot) const { return stats(slot).count; }
+
+        uint32_t minMicros(ProfileSlot slot) const;
+
+        uint32_t avgMicros(ProfileSlot slot) const;
+
+        uint32_t maxMicros(ProfileSlot slot) const { return toMicros(stats(slot).maxCycles); }
+
+        uint32_t overruns(ProfileSlot slot) const { return stats(slot).overruns; }
+
+        /**
+         * Upper bound of the histogram bucket containing the given percentile, in microseconds.
+         */
+        uint32_t percentileMicros(ProfileSlot slot, uint8_t percentile) const;
+
+        void printStats();
+
+        uint16_t telemetryInterval() const { return mTelemetryInterval; }
+
+        void setTelemetryInterval(uint16_t seconds);
+
+        void begin();
+
+        void loop();
+};
@@ -18,33 +18,7 @@
 
 const char *TOPIC_LEDS = "leds/";
 const char *TOPIC_PROJECTOR = "projector/";
-
-const char *strRGBMode(RGBMode mode)
-{
-    switch (mode) {
-        case RGB_ON:
-            return "on";
-        case RGB_CYCLE:
-            return "cycle";
-        case RGB_FIRE:
-            return "fire";
-        case RGB_DIMMED:
-            return "dimmed";
-        case RGB_SPIN:
-            return "spin";
-        case RGB_SCAN:
-            return "scan";
-        case RGB_JUGGLE:
-            return "juggle";
-        case RGB_BPM:
-            return "bpm";
-        case RGB_RAINBOW:
-            return "rainbow";
-        case RGB_WATER:
-            return "water";
-    }
-    return "";
-}
+const char *TOPIC_SYSTEM = "system/";
 
 const char *strProjectorCommand(ProjectorCommand cmd)
 {
@@ -81,51 +55,6 @@ const char *strBool(bool value)
     return value ? "on" : "off";
 }
 
-bool parseRGBMode(const char *str, RGBMode &mode)
-{
-    if (strcmp(str, "on") == 0) {
-        mode = RGB_ON;
-        return true;
-    }
-    if (strcmp(str, "cycle") == 0) {
-        mode = RGB_CYCLE;
-        return true;
-    }
-    if (strcmp(str, "fire") == 0) {
-        mode = RGB_FIRE;
-        return true;
-    }
-    if (strcmp(str, "dimmed") == 0) {
-        mode = RGB_DIMMED;
-        return true;
-    }
-    if (strcmp(str, "spin") == 0) {
-        mode = RGB_SPIN;
-        return true;
-    }
-    if (strcmp(str, "scan") == 0) {
-        mode = RGB_SCAN;
-        return true;
-    }
-    if (strcmp(str, "juggle") == 0) {
-        mode = RGB_JUGGLE;
-        return true;
-    }
-    if (strcmp(str, "bpm") == 0) {
-        mode = RGB_BPM;
-        return true;
-    }
-    if (strcmp(str, "rainbow") == 0) {
-        mode = RGB_RAINBOW;
-        return true;
-    }
-    if (strcmp(str, "water") == 0) {
-        mode = RGB_WATER;
-        return true;
-    }
-    return false;
-}
-
 bool parseProjectorCommand(const char *str, ProjectorCommand &cmd)
 {
     if (strcmp(str, "off") == 0) {
@@ -236,6 +165,9 @@ void MqttClient::registerClient(MqttSubtopic subtopic, MqttTopicCallback callbac
                 mProjectorSubscribeCallback();
             }
             break;
+        case MQS_SYSTEM:
+            // Publish only
+            break;
     }
 }
 
@@ -249,6 +181,9 @@ void MqttClient::publish(MqttSubtopic subtopic, const char* key, const char* val
         case MQS_PROJECTOR:
             topic += TOPIC_PROJECTOR;
             break;
+        case MQS_SYSTEM:
+            topic += TOPIC_SYSTEM;
+            break;
     }
     topic += key;
 
@@ -270,6 +205,9 @@ void MqttClient::subscribe(MqttSubtopic subtopic, const char* key)
         case MQS_PROJECTOR:
             topic += TOPIC_PROJECTOR;
             break;
+        case MQS_SYSTEM:
+            topic += TOPIC_SYSTEM;
+            break;
     }
     topic += key;
 
@@ -22,16 +22,12 @@
 using MqttTopicCallback = std::function<void(const char *key, const char *payload, unsigned int length)>;
 using MqttSubscribeCallback = std::function<void()>;
 
-const char *strRGBMode(RGBMode mode);
-
 const char *strProjectorCommand(ProjectorCommand cmd);
 
 const char *strLiftCommand(LiftCommand cmd);
 
 const char *strBool(bool value);
 
-bool parseRGBMode(const char *str, RGBMode &mode);
-
 bool parseProjectorCommand(const char *str, ProjectorCommand &cmd);
 
 bool parseLiftCommand(const char *str, LiftCommand &cmd);
@@ -41,7 +37,8 @@ bool parseBool(const char* str, bool &value);
 enum MqttSubtopic
 {
     MQS_LEDS,
-    MQS_PROJECTOR
+    MQS_PROJECTOR,
+    MQS_SYSTEM
 };
 
 class MqttClient
@@ -0,0 +1,82 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Value noise implementation.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "NoiseField.h"
+
+#include <FastLED.h>
+
+// Weight of each octave in 1/256, halving with each octave
+static const uint8_t OCTAVE_WEIGHTS[NOISE_OCTAVES] = { 146, 73, 37 };
+
+/**
+ * Random value of a lattice point.
+ */
+static inline uint8_t latticeValue(uint32_t x, uint32_t t, uint8_t seed)
+{
+    uint32_t h = x * 0x9E3779B1u ^ (t + ((uint32_t) seed << 16)) * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0xC2B2AE3Du;
+    h ^= h >> 13;
+    return h >> 24;
+}
+
+void NoiseField::start(uint8_t seed, uint8_t cellPixels, uint16_t speed)
+{
+    if (cellPixels < NOISE_MIN_CELL_PIXELS) {
+        cellPixels = NOISE_MIN_CELL_PIXELS;
+    }
+
+    mSeed = seed;
+    mStep = 256 / cellPixels;
+    mSpeed = speed;
+    mTime = 0;
+    mPhase.reset();
+
+    updatePoints();
+}
+
+void NoiseField::advance(uint32_t dt)
+{
+    mTime += mPhase.advance(mSpeed, dt);
+    updatePoints();
+}
+
+void NoiseField::updatePoints()
+{
+    for (uint8_t k = 0; k < NOISE_OCTAVES; k++) {
+        // Finer octaves also change faster
+        uint32_t time = mTime << k;
+        uint32_t t = time >> 8;
+        uint8_t fraction = ease8InOutQuad(time & 0xFF);
+        uint8_t seed = mSeed + k * 85;
+        // Up to the point after the cell of the last pixel
+        uint16_t points = (((uint32_t) (NUM_LEDS - 1) * mStep << k) >> 8) + 2;
+
+        uint8_t *row = mPoints[k];
+        for (uint16_t x = 0; x < points; x++) {
+            row[x] = lerp8by8(latticeValue(x, t, seed), latticeValue(x, t + 1, seed), fraction);
+        }
+    }
+}
+
+uint8_t NoiseField::sample(uint16_t pixel) const
+{
+    uint32_t x = (uint32_t) pixel * mStep;
+    uint16_t sum = 0;
+
+    for (uint8_t k = 0; k < NOISE_OCTAVES; k++) {
+        uint32_t position = x << k;
+        uint16_t cell = position >> 8;
+        const uint8_t *row = mPoints[k];
+
+        sum += lerp8by8(row[cell], row[cell + 1], ease8InOutQuad(position & 0xFF)) * OCTAVE_WEIGHTS[k];
+    }
+    return sum >> 8;
+}
@@ -0,0 +1,70 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Smooth value noise along the strip, changing over time.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include "config.h"
+#include "PhaseAccumulator.h"
+
+// Noise layers summed up, each with twice the detail and half the weight of the previous one
+static const uint8_t NOISE_OCTAVES = 3;
+
+// Smallest lattice cell of the first octave, in pixels
+static const uint8_t NOISE_MIN_CELL_PIXELS = 8;
+
+// Lattice points per octave for the smallest cells, including the point past the last pixel
+static const uint16_t NOISE_MAX_POINTS = ((NUM_LEDS << (NOISE_OCTAVES - 1)) / NOISE_MIN_CELL_PIXELS) + 2;
+
+/**
+ * 2D value noise over the pixel position and time.
+ *
+ * advance() interpolates every octave along the time axis once per frame, for all lattice points
+ * along the strip. Sampling a pixel then only interpolates between two cached lattice points per
+ * octave, instead of evaluating the full 2D noise for every pixel like inoise8().
+ */
+class NoiseField
+{
+    private:
+        // Noise at the lattice points for the current time, per octave
+        uint8_t  mPoints[NOISE_OCTAVES][NOISE_MAX_POINTS];
+
+        // Lattice units of the first octave per pixel, 8.8 fixed point
+        uint16_t mStep = 0;
+        uint8_t  mSeed = 0;
+
+        // Time in lattice units of the first octave, 8.8 fixed point
+        uint32_t mTime = 0;
+        uint16_t mSpeed = 0;
+        PhaseAccumulator mPhase;
+
+        void updatePoints();
+
+    public:
+        /**
+         * Start a new noise field.
+         *
+         * @param seed: selects one of 256 different fields.
+         * @param cellPixels: pixels between the lattice points of the first octave, larger values give smoother noise.
+         * @param speed: time steps per second, 256 steps move the first octave by one lattice cell.
+         */
+        void start(uint8_t seed, uint8_t cellPixels, uint16_t speed);
+
+        /**
+         * Move the field along the time axis.
+         */
+        void advance(uint32_t dt);
+
+        /**
+         * Noise at a pixel, 0 to 255.
+         */
+        uint8_t sample(uint16_t pixel) const;
+};
@@ -0,0 +1,68 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Fixed format UDP packet input implementation.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "PacketInput.h"
+
+#include <string.h>
+
+#include "RealtimeInput.h"
+
+// Socket headers after the Arduino headers, they define INADDR_NONE as a macro.
+#if defined(ARDUINO_ARCH_ESP32)
+#include <lwip/sockets.h>
+#else
+#include <sys/socket.h>
+#endif
+
+static const uint8_t PACKET_MAGIC_LENGTH = 4;
+
+PacketInput::PacketInput(const char *tag, const char *name, uint16_t port, const uint8_t *magic, uint8_t length)
+: mTag(tag), mName(name), mMagic(magic), mPort(port), mLength(length)
+{
+}
+
+void PacketInput::begin()
+{
+    mStarted = true;
+
+    mSocket = RealtimeInput::openSocket(mPort);
+    if (mSocket < 0) {
+        Serial.printf("[%s] Could not open %s port %hu\n", mTag, mName, mPort);
+    } else {
+        Serial.printf("[%s] Listening for %s on port %hu\n", mTag, mName, mPort);
+    }
+}
+
+bool PacketInput::poll()
+{
+    if (mSocket < 0) {
+        return false;
+    }
+
+    bool received = false;
+
+    for (uint8_t i = 0; i < REALTIME_MAX_PACKETS; i++) {
+        uint8_t packet[PACKET_INPUT_MAX_LENGTH];
+
+        int length = recv(mSocket, packet, sizeof(packet), MSG_DONTWAIT);
+        if (length < 0) {
+            break;
+        }
+        mPacketCount++;
+
+        // Nothing is decoded from packets which are too short for the payload
+        if (length < mLength || memcmp(packet, mMagic, PACKET_MAGIC_LENGTH) != 0 || !decode(packet)) {
+            mInvalidCount++;
+            continue;
+        }
+        received = true;
+    }
+    return received;
+}
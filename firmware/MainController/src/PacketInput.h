@@ -0,0 +1,74 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Base of the small fixed format UDP inputs (beat clock, audio spectrum).
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include "config.h"
+
+// Longest packet of the packet inputs, longer packets are truncated to this length
+static const uint8_t PACKET_INPUT_MAX_LENGTH = 32;
+
+/**
+ * Receives packets which start with a 4 byte magic and have a fixed length, on their own port.
+ *
+ * Subclasses only decode the payload. Owned and polled by the render task.
+ */
+class PacketInput
+{
+    private:
+        const char    *mTag;
+        const char    *mName;
+        const uint8_t *mMagic;
+        uint16_t       mPort;
+        uint8_t        mLength;
+
+        int      mSocket = -1;
+        bool     mStarted = false;
+
+        uint32_t mPacketCount = 0;
+        uint32_t mInvalidCount = 0;
+
+    protected:
+        /**
+         * @param tag: log tag, without the brackets.
+         * @param name: what the input receives, for the log.
+         * @param magic: 4 bytes every packet starts with.
+         * @param length: packet length including the magic, at most PACKET_INPUT_MAX_LENGTH.
+         */
+        PacketInput(const char *tag, const char *name, uint16_t port, const uint8_t *magic, uint8_t length);
+
+        /**
+         * Decode a packet with the magic and the expected length.
+         *
+         * @return false if the payload is invalid.
+         */
+        virtual bool decode(const uint8_t *packet) = 0;
+
+        /**
+         * Receive and decode all pending packets, at most REALTIME_MAX_PACKETS per call.
+         *
+         * @return true if at least one packet has been decoded.
+         */
+        bool poll();
+
+    public:
+        /**
+         * Bind the listening socket. Requires the network stack to be up.
+         */
+        void begin();
+
+        bool isStarted() const { return mStarted; }
+
+        uint32_t packetCount() const { return mPacketCount; }
+
+        uint32_t invalidCount() const { return mInvalidCount; }
+};
@@ -0,0 +1,152 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Fixed capacity particle pool for moving objects on the strip.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <FastLED.h>
+
+// Particles with this life are never removed by age
+static const uint16_t PARTICLE_IMMORTAL = 0xFFFF;
+
+// Longest time step integrated at once, so that long frames neither overflow nor tunnel through the floor
+static const uint32_t PARTICLE_MAX_STEP_MS = 50;
+
+/**
+ * Pool of up to Capacity particles, without any heap allocation.
+ *
+ * Positions are in 1/256 pixels from the start of the rendered range, velocities in 1/256 pixels per
+ * second. Every attribute is kept in its own array and the live particles are packed at the front, so
+ * that the update loops run over contiguous memory. Removing a particle moves the last one into its
+ * slot, the order of the particles is not kept.
+ */
+template<uint16_t Capacity>
+class ParticlePool
+{
+    public:
+        static const uint16_t CAPACITY = Capacity;
+
+        int32_t  position[Capacity];
+        int32_t  velocity[Capacity];
+        // Remaining life in milliseconds, the particle fades out over its last 255 ms
+        uint16_t life[Capacity];
+        CRGB     color[Capacity];
+
+    private:
+        uint16_t mCount = 0;
+
+        void remove(uint16_t index)
+        {
+            mCount--;
+            position[index] = position[mCount];
+            velocity[index] = velocity[mCount];
+            life[index] = life[mCount];
+            color[index] = color[mCount];
+        }
+
+        void integrate(uint32_t dt, int32_t gravity, uint8_t bounce, int32_t end);
+
+    public:
+        uint16_t count() const { return mCount; }
+
+        bool isFull() const { return mCount == Capacity; }
+
+        void clear() { mCount = 0; }
+
+        /**
+         * Add a particle, if there is room left.
+         *
+         * @return the index of the particle, or -1 if the pool is full.
+         */
+        int spawn(int32_t pos, int32_t vel, uint16_t lifeMillis, const CRGB &rgb)
+        {
+            if (mCount == Capacity) {
+                return -1;
+            }
+            position[mCount] = pos;
+            velocity[mCount] = vel;
+            life[mCount] = lifeMillis;
+            color[mCount] = rgb;
+            return mCount++;
+        }
+
+        /**
+         * Move all particles by the elapsed time and remove the expired ones.
+         *
+         * @param gravity: acceleration toward the start of the range, in 1/256 pixels per second squared.
+         * @param bounce: share of the speed kept when a particle hits the start of the range, 0 removes it.
+         * @param length: pixels in the range, particles beyond its end are removed.
+         */
+        void step(uint32_t dt, int32_t gravity, uint8_t bounce, uint16_t length)
+        {
+            while (dt > 0) {
+                uint32_t part = dt < PARTICLE_MAX_STEP_MS ? dt : PARTICLE_MAX_STEP_MS;
+                integrate(part, gravity, bounce, (int32_t) length << 8);
+                dt -= part;
+            }
+        }
+
+        /**
+         * Add all particles to the pixels, spread over the two pixels next to their position.
+         */
+        void render(CRGB *leds, uint16_t length) const;
+};
+
+template<uint16_t Capacity>
+void ParticlePool<Capacity>::integrate(uint32_t dt, int32_t gravity, uint8_t bounce, int32_t end)
+{
+    // Same for all particles: the speed change and the time step as 16.16 fraction of a second
+    const int32_t dv = gravity * (int32_t) dt / 1000;
+    const int32_t scale = (dt << 16) / 1000;
+
+    uint16_t i = 0;
+    while (i < mCount) {
+        int32_t v = velocity[i] - dv;
+        int32_t p = position[i] + (v * scale >> 16);
+
+        if (p < 0 && bounce > 0) {
+            // Reflect at the floor, losing some of the speed
+            p = -p;
+            v = -v * bounce >> 8;
+        }
+        if (life[i] != PARTICLE_IMMORTAL) {
+            life[i] = life[i] > dt ? life[i] - dt : 0;
+        }
+        if (p < 0 || p >= end || life[i] == 0) {
+            remove(i);
+            continue;
+        }
+        position[i] = p;
+        velocity[i] = v;
+        i++;
+    }
+}
+
+template<uint16_t Capacity>
+void ParticlePool<Capacity>::render(CRGB *leds, uint16_t length) const
+{
+    for (uint16_t i = 0; i < mCount; i++) {
+        uint16_t index = position[i] >> 8;
+        uint8_t fraction = position[i] & 0xFF;
+
+        CRGB rgb = color[i];
+        if (life[i] < 255) {
+            rgb.nscale8_video(life[i]);
+        }
+
+        CRGB part = rgb;
+        leds[index] += part.nscale8_video(255 - fraction);
+        if (index + 1 < length) {
+            part = rgb;
+            leds[index + 1] += part.nscale8_video(fraction);
+        }
+    }
+}
@@ -0,0 +1,40 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Fixed-point accumulator to advance animation parameters by a rate per second,
+ * independent of the frame rate.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+class PhaseAccumulator
+{
+    private:
+        // Fractional part of the phase, 16.16 fixed point
+        uint32_t mFraction = 0;
+
+    public:
+        void reset() { mFraction = 0; }
+
+        /**
+         * Advance the phase by the elapsed time.
+         *
+         * @param unitsPerSecond: speed of the animated parameter.
+         * @param dtMillis: time since the last call.
+         * @return the number of whole units to step the parameter by. The remainder is kept for the next call.
+         */
+        uint32_t advance(uint32_t unitsPerSecond, uint32_t dtMillis)
+        {
+            mFraction += (uint32_t) ((((uint64_t) unitsPerSecond * dtMillis) << 16) / 1000);
+
+            uint32_t steps = mFraction >> 16;
+            mFraction &= 0xFFFF;
+            return steps;
+        }
+};
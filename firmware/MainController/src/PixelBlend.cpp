@@ -0,0 +1,44 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Packed pixel kernels implementation.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "PixelBlend.h"
+
+#include <string.h>
+
+// Every other byte of a word, each lane has 8 bit of headroom for the products
+static const uint32_t LANE_MASK = 0x00FF00FF;
+
+void blendPixels(const CRGB *from, const CRGB *to, CRGB *out, int numLeds, uint8_t amount)
+{
+    const uint8_t *a = (const uint8_t*) __builtin_assume_aligned(from, 4);
+    const uint8_t *b = (const uint8_t*) __builtin_assume_aligned(to, 4);
+    uint8_t *o = (uint8_t*) __builtin_assume_aligned(out, 4);
+
+    uint32_t wb = amount;
+    uint32_t wa = 256 - wb;
+    int bytes = numLeds * 3;
+    int i = 0;
+
+    // Four channels per step, in two lanes of two channels each
+    for (; i + 4 <= bytes; i += 4) {
+        uint32_t pa, pb;
+        memcpy(&pa, a + i, 4);
+        memcpy(&pb, b + i, 4);
+
+        uint32_t even = ((pa & LANE_MASK) * wa + (pb & LANE_MASK) * wb) >> 8;
+        uint32_t odd = ((pa >> 8) & LANE_MASK) * wa + ((pb >> 8) & LANE_MASK) * wb;
+
+        uint32_t po = (even & LANE_MASK) | (odd & ~LANE_MASK);
+        memcpy(o + i, &po, 4);
+    }
+    for (; i < bytes; i++) {
+        o[i] = (a[i] * wa + b[i] * wb) >> 8;
+    }
+}
@@ -0,0 +1,22 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Packed pixel kernels, processing several color channels per 32 bit word.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <FastLED.h>
+
+/**
+ * Blend two frames channel by channel: out = (from * (256 - amount) + to * amount) / 256.
+ *
+ * All buffers must be 4-byte aligned, out may be the same as from or to.
+ */
+void blendPixels(const CRGB *from, const CRGB *to, CRGB *out, int numLeds, uint8_t amount);
@@ -0,0 +1,344 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Realtime pixel input implementation.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "RealtimeInput.h"
+
+#include <string.h>
+
+// Socket headers after the Arduino headers, they define INADDR_NONE as a macro.
+#if defined(ARDUINO_ARCH_ESP32)
+#include <lwip/sockets.h>
+#else
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(CRGB) == 3, "Pixel data is received directly into the CRGB framebuffer");
+
+static const uint32_t FRAME_BYTES = (uint32_t) NUM_LEDS * 3;
+
+/* DDP, see http://www.3waylabs.com/ddp/ */
+
+static const uint8_t DDP_HEADER_LENGTH   = 10;
+static const uint8_t DDP_TIMECODE_LENGTH = 4;
+
+static const uint8_t DDP_FLAGS_VERSION_MASK = 0xC0;
+static const uint8_t DDP_FLAGS_VERSION_1    = 0x40;
+static const uint8_t DDP_FLAGS_TIMECODE     = 0x10;
+static const uint8_t DDP_FLAGS_STORAGE      = 0x08;
+static const uint8_t DDP_FLAGS_REPLY        = 0x04;
+static const uint8_t DDP_FLAGS_QUERY        = 0x02;
+static const uint8_t DDP_FLAGS_PUSH         = 0x01;
+
+static const uint8_t DDP_TYPE_UNDEFINED = 0x00;
+// RGB pixels, 8 bits per channel
+static const uint8_t DDP_TYPE_RGB8      = 0x0B;
+static const uint8_t DDP_TYPE_RESERVED  = 0x40;
+
+static const uint8_t DDP_ID_DISPLAY = 1;
+static const uint8_t DDP_ID_ALL     = 255;
+
+/* E1.31 (sACN) data packets, ANSI E1.31-2018 */
+
+static const uint8_t E131_HEADER_LENGTH = 126;
+
+static const uint8_t E131_ACN_ID[12] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+
+static const uint8_t E131_OFFSET_ACN_ID        = 4;
+static const uint8_t E131_OFFSET_ROOT_VECTOR   = 18;
+static const uint8_t E131_OFFSET_FRAME_VECTOR  = 40;
+static const uint8_t E131_OFFSET_OPTIONS       = 112;
+static const uint8_t E131_OFFSET_UNIVERSE      = 113;
+static const uint8_t E131_OFFSET_DMP_VECTOR    = 117;
+static const uint8_t E131_OFFSET_ADDRESS_TYPE  = 118;
+static const uint8_t E131_OFFSET_VALUE_COUNT   = 123;
+static const uint8_t E131_OFFSET_START_CODE    = 125;
+
+static const uint32_t E131_VECTOR_ROOT_DATA     = 0x00000004;
+// Synchronization and discovery packets, ignored
+static const uint32_t E131_VECTOR_ROOT_EXTENDED = 0x00000008;
+static const uint32_t E131_VECTOR_DATA_PACKET   = 0x00000002;
+static const uint8_t  E131_VECTOR_DMP_SET       = 0x02;
+static const uint8_t  E131_ADDRESS_TYPE         = 0xA1;
+
+static const uint8_t E131_OPTION_PREVIEW    = 0x80;
+static const uint8_t E131_OPTION_TERMINATED = 0x40;
+
+// Whole pixels per DMX universe of 512 slots
+static const uint16_t E131_UNIVERSE_BYTES = 170 * 3;
+static const uint16_t E131_NUM_UNIVERSES = (FRAME_BYTES + E131_UNIVERSE_BYTES - 1) / E131_UNIVERSE_BYTES;
+
+
+static uint16_t readU16(const uint8_t *data)
+{
+    return ((uint16_t) data[0] << 8) | data[1];
+}
+
+static uint32_t readU32(const uint8_t *data)
+{
+    return ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint32_t) data[2] << 8) | data[3];
+}
+
+/**
+ * Peek at the header of the next pending datagram without removing it from the socket.
+ *
+ * @return the number of header bytes available, or -1 if no datagram is pending.
+ */
+static int peekHeader(int socket, uint8_t *header, size_t length)
+{
+    return recv(socket, header, length, MSG_PEEK | MSG_DONTWAIT);
+}
+
+/**
+ * Remove the pending datagram from the socket.
+ */
+static void dropPacket(int socket)
+{
+    uint8_t scratch;
+    recv(socket, &scratch, 1, MSG_DONTWAIT);
+}
+
+/**
+ * Receive the pending datagram, the header into the header buffer and the payload directly to its destination.
+ * Payload bytes beyond the given length are discarded.
+ *
+ * @return the number of payload bytes received.
+ */
+static int receivePayload(int socket, uint8_t *header, size_t headerLength, uint8_t *payload, size_t length)
+{
+    struct iovec iov[2];
+    iov[0].iov_base = header;
+    iov[0].iov_len = headerLength;
+    iov[1].iov_base = payload;
+    iov[1].iov_len = length;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+
+    int received = recvmsg(socket, &msg, MSG_DONTWAIT);
+    return received > (int) headerLength ? received - headerLength : 0;
+}
+
+int RealtimeInput::openSocket(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (bind(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool RealtimeInput::receiveDDP(uint8_t *pixels, bool &updated)
+{
+    uint8_t header[DDP_HEADER_LENGTH + DDP_TIMECODE_LENGTH];
+
+    int available = peekHeader(mDDPSocket, header, sizeof(header));
+    if (available < 0) {
+        return false;
+    }
+    mPacketCount++;
+
+    uint8_t flags = header[0];
+    uint8_t type = header[2] & ~DDP_TYPE_RESERVED;
+    uint8_t id = header[3];
+    size_t headerLength = DDP_HEADER_LENGTH + (flags & DDP_FLAGS_TIMECODE ? DDP_TIMECODE_LENGTH : 0);
+
+    if (available < (int) headerLength ||
+        (flags & DDP_FLAGS_VERSION_MASK) != DDP_FLAGS_VERSION_1 ||
+        (type != DDP_TYPE_UNDEFINED && type != DDP_TYPE_RGB8))
+    {
+        mInvalidCount++;
+        dropPacket(mDDPSocket);
+        return true;
+    }
+
+    uint32_t offset = readU32(header + 4);
+    uint32_t length = readU16(header + 8);
+
+    // Only plain writes to the whole display
+    if (!pixels || (flags & (DDP_FLAGS_QUERY | DDP_FLAGS_REPLY | DDP_FLAGS_STORAGE)) ||
+        (id != DDP_ID_DISPLAY && id != DDP_ID_ALL) || offset >= FRAME_BYTES)
+    {
+        dropPacket(mDDPSocket);
+        return true;
+    }
+    if (length > FRAME_BYTES - offset) {
+        length = FRAME_BYTES - offset;
+    }
+
+    int received = receivePayload(mDDPSocket, header, headerLength, pixels + offset, length);
+    if (received < (int) length) {
+        mInvalidCount++;
+    }
+    if (received > 0) {
+        // Senders split long strips over several packets and push the frame with the last one.
+        // Senders which never push end their frames at the strip length.
+        bool complete = (flags & DDP_FLAGS_PUSH) || offset + received >= FRAME_BYTES;
+        mFramePending = !complete;
+        updated |= complete;
+    }
+    return true;
+}
+
+bool RealtimeInput::receiveE131(uint8_t *pixels, bool &updated)
+{
+    uint8_t header[E131_HEADER_LENGTH];
+
+    int available = peekHeader(mE131Socket, header, sizeof(header));
+    if (available < 0) {
+        return false;
+    }
+    mPacketCount++;
+
+    if (available >= E131_OFFSET_ROOT_VECTOR + 4 && readU32(header + E131_OFFSET_ROOT_VECTOR) == E131_VECTOR_ROOT_EXTENDED) {
+        dropPacket(mE131Socket);
+        return true;
+    }
+
+    if (available < E131_HEADER_LENGTH ||
+        memcmp(header + E131_OFFSET_ACN_ID, E131_ACN_ID, sizeof(E131_ACN_ID)) != 0 ||
+        readU32(header + E131_OFFSET_ROOT_VECTOR) != E131_VECTOR_ROOT_DATA ||
+        readU32(header + E131_OFFSET_FRAME_VECTOR) != E131_VECTOR_DATA_PACKET ||
+        header[E131_OFFSET_DMP_VECTOR] != E131_VECTOR_DMP_SET ||
+        header[E131_OFFSET_ADDRESS_TYPE] != E131_ADDRESS_TYPE)
+    {
+        mInvalidCount++;
+        dropPacket(mE131Socket);
+        return true;
+    }
+
+    uint8_t options = header[E131_OFFSET_OPTIONS];
+    uint16_t universe = readU16(header + E131_OFFSET_UNIVERSE);
+    // Property values include the DMX start code
+    uint16_t slots = readU16(header + E131_OFFSET_VALUE_COUNT);
+
+    if (options & E131_OPTION_TERMINATED) {
+        // Sender has stopped, do not wait for the timeout
+        if (mActive) {
+            Serial.println("[RT] Realtime stream terminated by sender");
+        }
+        mActive = false;
+        mFramePending = false;
+        dropPacket(mE131Socket);
+        return true;
+    }
+
+    if (!pixels || (options & E131_OPTION_PREVIEW) || header[E131_OFFSET_START_CODE] != 0 || slots < 2 ||
+        universe < REALTIME_E131_UNIVERSE || universe >= REALTIME_E131_UNIVERSE + E131_NUM_UNIVERSES)
+    {
+        dropPacket(mE131Socket);
+        return true;
+    }
+
+    uint32_t offset = (uint32_t) (universe - REALTIME_E131_UNIVERSE) * E131_UNIVERSE_BYTES;
+    uint32_t length = slots - 1;
+    if (length > E131_UNIVERSE_BYTES) {
+        length = E131_UNIVERSE_BYTES;
+    }
+    if (length > FRAME_BYTES - offset) {
+        length = FRAME_BYTES - offset;
+    }
+
+    int received = receivePayload(mE131Socket, header, E131_HEADER_LENGTH, pixels + offset, length);
+    if (received < (int) length) {
+        mInvalidCount++;
+    }
+    if (received > 0) {
+        updated = true;
+    }
+    return true;
+}
+
+void RealtimeInput::begin()
+{
+    mStarted = true;
+
+    mDDPSocket = openSocket(REALTIME_DDP_PORT);
+    mE131Socket = openSocket(REALTIME_E131_PORT);
+
+    if (mE131Socket >= 0) {
+        // Senders commonly use the multicast group of each universe, 239.255.<universe>
+        for (uint16_t i = 0; i < E131_NUM_UNIVERSES; i++) {
+            uint16_t universe = REALTIME_E131_UNIVERSE + i;
+
+            struct ip_mreq group;
+            memset(&group, 0, sizeof(group));
+            group.imr_multiaddr.s_addr = htonl(0xEFFF0000 | universe);
+            group.imr_interface.s_addr = htonl(INADDR_ANY);
+            setsockopt(mE131Socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &group, sizeof(group));
+        }
+    }
+
+    if (mDDPSocket < 0 || mE131Socket < 0) {
+        Serial.printf("[RT] Could not open realtime input ports (DDP %s, E1.31 %s)\n",
+                      mDDPSocket < 0 ? "failed" : "ok", mE131Socket < 0 ? "failed" : "ok");
+    } else {
+        Serial.printf("[RT] Listening for DDP on port %hu, E1.31 on port %hu\n", REALTIME_DDP_PORT, REALTIME_E131_PORT);
+    }
+}
+
+bool RealtimeInput::receive(CRGB *leds, unsigned long now)
+{
+    uint8_t *pixels = (uint8_t*) leds;
+    bool updated = false;
+
+    for (uint8_t i = 0; i < REALTIME_MAX_PACKETS; i++) {
+        bool pending = false;
+
+        if (mDDPSocket >= 0) {
+            pending |= receiveDDP(pixels, updated);
+        }
+        if (mE131Socket >= 0) {
+            pending |= receiveE131(pixels, updated);
+        }
+        if (!pending) {
+            break;
+        }
+    }
+
+    if (updated) {
+        frameReceived(now);
+    }
+    return updated;
+}
+
+void RealtimeInput::frameReceived(unsigned long now)
+{
+    if (!mActive) {
+        Serial.println("[RT] Realtime input active");
+    }
+    mActive = true;
+    mLastFrame = now;
+}
+
+bool RealtimeInput::update(unsigned long now)
+{
+    if (mActive && now - mLastFrame >= REALTIME_TIMEOUT_MS) {
+        Serial.println("[RT] Realtime input timed out");
+        mActive = false;
+        mFramePending = false;
+    }
+    return mActive;
+}
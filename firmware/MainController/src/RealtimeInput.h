@@ -0,0 +1,93 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Realtime pixel input over UDP, using the DDP and E1.31 (sACN) protocols.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <FastLED.h>
+
+#include "config.h"
+
+/**
+ * Receives pixel frames from a UDP sender such as a media PC.
+ *
+ * Packets are read straight from the socket into the framebuffer: only the protocol header is
+ * copied to the stack, the pixel payload is received into its place in the strip buffer.
+ * Owned and polled by the render task.
+ */
+class RealtimeInput
+{
+    private:
+        int           mDDPSocket = -1;
+        int           mE131Socket = -1;
+        bool          mStarted = false;
+
+        // Time of the last valid frame
+        unsigned long mLastFrame = 0;
+        bool          mActive = false;
+        // Pixels of a DDP frame have been written, but the frame has not been pushed yet
+        bool          mFramePending = false;
+
+        uint32_t      mPacketCount = 0;
+        uint32_t      mInvalidCount = 0;
+
+        /**
+         * Receive one DDP packet. Returns false if there is no packet pending.
+         */
+        bool receiveDDP(uint8_t *pixels, bool &updated);
+
+        /**
+         * Receive one E1.31 data packet. Returns false if there is no packet pending.
+         */
+        bool receiveE131(uint8_t *pixels, bool &updated);
+
+    public:
+        /**
+         * Bind a UDP socket to the port on all interfaces, -1 on failure.
+         */
+        static int openSocket(uint16_t port);
+
+        /**
+         * Bind the listening sockets. Requires the network stack to be up.
+         */
+        void begin();
+
+        bool isStarted() const { return mStarted; }
+
+        /**
+         * Receive all pending packets.
+         *
+         * @param leds: framebuffer to write the pixels to, or nullptr to drop the packets.
+         * @return true if a complete frame was written to leds.
+         */
+        bool receive(CRGB *leds, unsigned long now);
+
+        /**
+         * Activate the realtime input for a frame received from another source.
+         */
+        void frameReceived(unsigned long now);
+
+        /**
+         * Check if realtime frames are being received, deactivates the input after REALTIME_TIMEOUT_MS.
+         */
+        bool update(unsigned long now);
+
+        bool isActive() const { return mActive; }
+
+        /**
+         * Check if the framebuffer holds the first part of a frame, which must not be shown until it is complete.
+         */
+        bool isFramePending() const { return mFramePending; }
+
+        uint32_t packetCount() const { return mPacketCount; }
+
+        uint32_t invalidCount() const { return mInvalidCount; }
+};
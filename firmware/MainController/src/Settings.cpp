@@ -14,6 +14,8 @@
 
 #include <commands.h>
 
+#include "config.h"
+
 static const char* PREF_NAMESPACE = "Prefs";
 
 Preferences myPrefs;
@@ -84,10 +86,33 @@ void Settings::setDimmedIntensity(uint8_t value)
     mChanged = true;
 }
 
+bool Settings::isDitherEnabled()
+{
+    return myPrefs.getUChar("dither", 0);
+}
+
+void Settings::setDitherEnabled(bool enabled)
+{
+    myPrefs.putUChar("dither", enabled);
+    mChanged = true;
+}
+
+uint16_t Settings::rampTime()
+{
+    return myPrefs.getUShort("ramp", LED_RAMP_MS);
+}
+
+void Settings::setRampTime(uint16_t millis)
+{
+    myPrefs.putUShort("ramp", millis);
+    mChanged = true;
+}
+
 
 CHSV Settings::getHSV()
 {
-    uint8_t hsv[3];
+    // Defaults if nothing has been stored yet
+    uint8_t hsv[3] = {0, 0, 0};
     CHSV chsv;
 
     myPrefs.getBytes("hsv", hsv, sizeof(hsv));
@@ -172,3 +197,13 @@ void Settings::setMQTTClient(const char *clientId, const char *username, const c
     myPrefs.putString("mqttUser", username);
     myPrefs.putString("mqttPass", password);
 }
+
+uint16_t Settings::perfTelemetryInterval()
+{
+    return myPrefs.getUShort("perfInterval", 0);
+}
+
+void Settings::setPerfTelemetryInterval(uint16_t seconds)
+{
+    myPrefs.putUShort("perfInterval", seconds);
+}
@@ -38,6 +38,10 @@ class Settings
 
         uint8_t dimmedIntensity();
 
+        bool    isDitherEnabled();
+
+        uint16_t rampTime();
+
         CHSV getHSV();
 
         String getWiFiSSID();
@@ -58,6 +62,8 @@ class Settings
 
         String getMQTTPassword();
 
+        uint16_t perfTelemetryInterval();
+
 
         void setLampEnabled(bool enabled);
 
@@ -69,6 +75,10 @@ class Settings
 
         void setDimmedIntensity(uint8_t intensity);
 
+        void setDitherEnabled(bool enabled);
+
+        void setRampTime(uint16_t millis);
+
         void setHSV(uint8_t hue, uint8_t saturation, uint8_t value);
 
         void setWiFiAccess(const char *ssid, const char *password);
@@ -79,6 +89,8 @@ class Settings
 
         void setMQTTClient(const char *clientID, const char *username, const char *password);
 
+        void setPerfTelemetryInterval(uint16_t seconds);
+
         /**
          * Return true if any setting was changed since the last call to clearChanged().
          */
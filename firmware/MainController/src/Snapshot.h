@@ -0,0 +1,72 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Lock-free triple buffer to pass a state snapshot from one writer task to one reader task.
+ * The reader always sees a complete state, the writer never blocks.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <atomic>
+
+template<typename T>
+class Snapshot
+{
+    private:
+        static const uint32_t INDEX_MASK = 0x03;
+        // Set when the shared slot holds a state the reader has not seen yet
+        static const uint32_t FRESH = 0x04;
+
+        T mBuffers[3];
+
+        // Owned by the writer
+        uint32_t mWriteIndex = 0;
+        // Owned by the reader
+        uint32_t mReadIndex = 1;
+        // Slot exchanged between writer and reader
+        std::atomic<uint32_t> mShared{2};
+
+    public:
+        Snapshot() {}
+
+        /**
+         * Slot to fill by the writer. Contents are undefined, write the complete state before publish().
+         */
+        T &writeBuffer() { return mBuffers[mWriteIndex]; }
+
+        /**
+         * Make the write buffer available to the reader.
+         */
+        void publish()
+        {
+            mWriteIndex = mShared.exchange(mWriteIndex | FRESH) & INDEX_MASK;
+        }
+
+        void publish(const T &state)
+        {
+            writeBuffer() = state;
+            publish();
+        }
+
+        /**
+         * Fetch the latest published state, if any.
+         *
+         * @return true if a new state is available via read().
+         */
+        bool update()
+        {
+            if (!(mShared.load() & FRESH)) {
+                return false;
+            }
+            mReadIndex = mShared.exchange(mReadIndex) & INDEX_MASK;
+            return true;
+        }
+
+        const T &read() const { return mBuffers[mReadIndex]; }
+};
@@ -0,0 +1,41 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Temporal dithering implementation.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#include "TemporalDither.h"
+
+void TemporalDither::reset()
+{
+    for (int i = 0; i < NUM_LEDS; i++) {
+        for (int c = 0; c < 3; c++) {
+            // Golden ratio sequence, evenly spread without a visible pattern
+            mError[i][c] = (uint8_t) ((i * 3 + c) * 158);
+        }
+    }
+}
+
+bool TemporalDither::apply(const CRGB *pixels, CRGB *output, int numLeds, const uint16_t scale[3])
+{
+    uint8_t residual = 0;
+
+    for (int i = 0; i < numLeds; i++) {
+        for (int c = 0; c < 3; c++) {
+            // 8 bit pixel times 16 bit scale in 8.8 fixed point. The scale counts up to 65536 like in scale8(),
+            // so that a full pixel at full scale lands exactly on 255 and leaves no residual.
+            uint32_t value = ((uint32_t) pixels[i].raw[c] * ((uint32_t) scale[c] + 1)) >> 8;
+            // Output only alternates if the value falls between two 8 bit steps
+            residual |= value & 0xFF;
+
+            value += mError[i][c];
+            output[i].raw[c] = value >> 8;
+            mError[i][c] = value & 0xFF;
+        }
+    }
+    return residual != 0;
+}
@@ -0,0 +1,42 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * High-precision output stage which scales frames with 16 bit resolution
+ * and quantizes them to 8 bit with error diffusion across frames.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <FastLED.h>
+
+#include "config.h"
+
+class TemporalDither
+{
+    private:
+        // Fraction lost by the last quantization, added to the next frame, per pixel and channel
+        uint8_t mError[NUM_LEDS][3];
+
+    public:
+        TemporalDither() { reset(); }
+
+        /**
+         * Restart the error diffusion. The initial errors are spread over the strip, so that
+         * neighbouring pixels do not step up in the same frame.
+         */
+        void reset();
+
+        /**
+         * Scale the pixels into the 16 bit range and quantize them to the output.
+         *
+         * @param scale: 16 bit scale per channel, including brightness and color correction, 0xFFFF is full scale.
+         * @return true if any value falls between two 8 bit steps, so that the next frame differs.
+         */
+        bool apply(const CRGB *pixels, CRGB *output, int numLeds, const uint16_t scale[3]);
+};
@@ -0,0 +1,111 @@
+/*
+ * @project     FancyLights
+ * @author      Stefan Hepp, stefan@stefant.org
+ *
+ * Fixed-point ramp which eases an 8 bit value toward a target over a given time.
+ *
+ * Copyright 2025 Stefan Hepp
+ * License: GPL v3
+ * See 'COPYRIGHT.txt' for copyright and licensing information.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+class ValueRamp
+{
+    private:
+        // Values in 8.16 fixed point
+        static const uint32_t ONE = 1UL << 16;
+        static const uint32_t RANGE = 256UL << 16;
+
+        uint32_t mCurrent = 0;
+        uint32_t mTarget = 0;
+        // Step per millisecond, in 8.16 fixed point
+        uint32_t mRate = 0;
+        bool     mUp = true;
+        // Value wraps around, such as the hue, and moves along the shorter direction
+        bool     mWrap = false;
+
+    public:
+        explicit ValueRamp(bool wrap = false) : mWrap(wrap) {}
+
+        /**
+         * Jump to the given value and stop the ramp.
+         */
+        void set(uint8_t value)
+        {
+            mCurrent = mTarget = (uint32_t) value << 16;
+        }
+
+        /**
+         * Start moving from the current value toward a new target, so that it is reached after the given time.
+         * A running ramp keeps its current value, so repeated calls only change the target and the speed.
+         */
+        void moveTo(uint8_t target, uint32_t durationMillis)
+        {
+            mTarget = (uint32_t) target << 16;
+
+            uint32_t distance;
+            if (mWrap) {
+                uint32_t up = (mTarget - mCurrent) & (RANGE - 1);
+                mUp = up <= RANGE / 2;
+                distance = mUp ? up : RANGE - up;
+            } else {
+                mUp = mTarget >= mCurrent;
+                distance = mUp ? mTarget - mCurrent : mCurrent - mTarget;
+            }
+
+            if (durationMillis == 0) {
+                mCurrent = mTarget;
+                return;
+            }
+            mRate = distance / durationMillis;
+            if (mRate == 0) {
+                mRate = 1;
+            }
+        }
+
+        /**
+         * Advance the ramp by the elapsed time.
+         *
+         * @return true if the value has changed.
+         */
+        bool advance(uint32_t dtMillis)
+        {
+            if (mCurrent == mTarget) {
+                return false;
+            }
+            uint8_t previous = value();
+
+            uint64_t step = (uint64_t) mRate * dtMillis;
+            uint32_t distance = mUp ? mTarget - mCurrent : mCurrent - mTarget;
+            if (mWrap) {
+                distance &= RANGE - 1;
+            }
+
+            if (step >= distance) {
+                mCurrent = mTarget;
+            } else {
+                mCurrent = mUp ? mCurrent + (uint32_t) step : mCurrent - (uint32_t) step;
+                if (mWrap) {
+                    mCurrent &= RANGE - 1;
+                }
+            }
+            return value() != previous;
+        }
+
+        bool isActive() const { return mCurrent != mTarget; }
+
+        /**
+         * Current value, rounded to the nearest step.
+         */
+        uint8_t value() const { return ((mCurrent + ONE / 2) >> 16) & 0xFF; }
+
+        /**
+         * Current value in 8.8 fixed point, for outputs with more than 8 bit resolution.
+         */
+        uint16_t value16() const { return mCurrent >> 8; }
+
+        uint8_t target() const { return mTarget >> 16; }
+};
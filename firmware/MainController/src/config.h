@@ -12,12 +12,18 @@
 
 #include <Arduino.h>
 
+#include <commands.h>
+
+#include "LEDLayout.h"
+
 /* ==================================================== */
 /* Common controller settings                           */
 /* ==================================================== */
 
 static const uint8_t PIN_RGB_DATA     = 22;
 static const uint8_t PIN_RGB_PWR      = 23;
+// Data pin of the second half of the strip with LED_PARALLEL_OUTPUT
+static const uint8_t PIN_RGB_DATA2    = 32;
 static const uint8_t PIN_LAMP1        = 19;
 static const uint8_t PIN_LAMP2        = 21;
 static const uint8_t PIN_SCREEN_UP    = 4;
@@ -33,3 +39,123 @@ static const uint8_t PIN_KP_TXD       = 5;
 static const uint8_t PIN_KP_RXD       = 18;
 static const uint8_t PIN_PR_TXD       = 17;
 static const uint8_t PIN_PR_RXD       = 16;
+
+// Lamp PWM. 13 bit is the highest LEDC resolution at this frequency with the 80 MHz APB clock.
+static const uint32_t LAMP_PWM_FREQUENCY = 5000;
+static const uint8_t  LAMP_PWM_BITS      = 13;
+static const uint16_t LAMP_PWM_MAX       = (1 << LAMP_PWM_BITS) - 1;
+
+/* ==================================================== */
+/* LED rendering                                        */
+/* ==================================================== */
+
+// Pixels on each side and in the center block. The build may override them, e.g. to benchmark longer strips.
+#ifndef LED_SIDE_LENGTH
+#define LED_SIDE_LENGTH 108
+#endif
+#ifndef LED_CENTER_LENGTH
+#define LED_CENTER_LENGTH 8
+#endif
+
+typedef LEDLayout<LED_SIDE_LENGTH, LED_CENTER_LENGTH> StripLayout;
+
+// Send each mirrored half on its own data pin, the second half is wired from the center to PIN_RGB_DATA2.
+//#define LED_PARALLEL_OUTPUT
+
+static const uint16_t NUM_LEDS = StripLayout::NUM_LEDS;
+
+static const uint16_t NUM_LEDS_CENTER = StripLayout::CENTER_LENGTH;
+
+// Animation frame period
+static const uint32_t LED_FRAME_PERIOD_MS = 20;
+
+// Shortest frame period for dynamic effects, the actual period is limited by the measured show() time.
+static const uint32_t LED_MIN_FRAME_PERIOD_MS = 8;
+
+// Longest frame period for dynamic effects, so that animations keep at least 25 fps on long strips.
+// Strips which take longer than this to send are sent out back to back.
+static const uint32_t LED_MAX_FRAME_PERIOD_MS = 40;
+
+// Longest time step applied to animations after a stall
+static const uint32_t LED_MAX_FRAME_DELTA_MS = 1000;
+
+// Default crossfade time between effects
+static const uint32_t LED_TRANSITION_MS = 1000;
+
+// Longest crossfade time accepted over MQTT
+static const uint32_t LED_MAX_TRANSITION_MS = 60000;
+
+// Default time to ease color and intensity changes over
+static const uint16_t LED_RAMP_MS = 300;
+
+// Tempo of the beat driven effects until a tempo is set, in beats per minute
+static const uint8_t LED_DEFAULT_BPM = 13;
+
+// Range of tempos accepted from taps, MQTT and the beat clock input
+static const uint8_t LED_MIN_BPM = TEMPO_MIN_BPM;
+static const uint8_t LED_MAX_BPM = 240;
+
+// Moving objects of the particle effects
+static const uint16_t LED_MAX_PARTICLES = 64;
+
+// Overlay layers above the effect, including the layer for the glitter of the effects
+static const uint8_t LED_NUM_LAYERS = 4;
+
+// Period of repeating overlays (flash, blink, sweep) without a lifetime
+static const uint32_t LED_OVERLAY_PERIOD_MS = 500;
+
+// Notifications waiting for the one being shown
+static const uint8_t LED_NOTIFY_QUEUE_LENGTH = 4;
+
+// Most blinks accepted for one notification
+static const uint8_t LED_NOTIFY_MAX_BLINKS = 20;
+
+// Run the LED frame loop in a separate FreeRTOS task. The host build renders from loop().
+#if defined(ARDUINO_ARCH_ESP32)
+#define LED_RENDER_TASK
+#endif
+
+// Render on the app core, above the Arduino loop task (priority 1), so that frames preempt loop() and loop()
+// runs between the frames. Not on the protocol core: the WiFi and lwIP tasks there run at higher priorities and
+// would delay the frames, and the RMT refill interrupts, which show() allocates on the calling core.
+static const uint8_t  RENDER_TASK_CORE     = 1;
+static const uint8_t  RENDER_TASK_PRIORITY = 3;
+// Stack in bytes. The render task opens the input sockets and logs through Serial.printf(), which needs about
+// 2 KB on its own. Debug builds log the high-water mark of the render task.
+static const uint32_t RENDER_TASK_STACK    = 6144;
+
+/* ==================================================== */
+/* Realtime pixel input                                 */
+/* ==================================================== */
+
+static const uint16_t REALTIME_DDP_PORT  = 4048;
+static const uint16_t REALTIME_E131_PORT = 5568;
+
+// Beat clock packets: "FLBT", the tempo in 1/256 BPM and the position within the current beat in 1/65536 beats,
+// both 16 bit big endian
+static const uint16_t BEAT_CLOCK_PORT = 4050;
+
+// Audio spectrum packets: "FLSP", an 8 bit sequence number and AUDIO_NUM_BANDS band levels from bass to treble,
+// 8 bit each. Senders analyze the audio they play and send a packet per analysis frame, typically 40 to 60 Hz.
+static const uint16_t AUDIO_SPECTRUM_PORT = 4051;
+static const uint8_t  AUDIO_NUM_BANDS = 16;
+
+// E1.31 universe holding the first pixels, following universes continue the strip
+static const uint16_t REALTIME_E131_UNIVERSE = 1;
+
+// Return to the selected RGB mode when no realtime frames arrive for this long
+static const uint32_t REALTIME_TIMEOUT_MS = 2500;
+
+// Upper bound of packets received per frame, so a flood cannot stall the render task
+static const uint8_t  REALTIME_MAX_PACKETS = 16;
+
+// Baud rate of the USB console. Serial frame streams run at the same rate, Adalight senders keep their
+// configured rate for the whole session, so they must be set to this rate. Fast enough for about 130 fps
+// on the default strip, keep monitor_speed in platformio.ini in sync.
+static const uint32_t SERIAL_CONSOLE_BAUD = 921600;
+
+// Receive buffer of the console, holds a full frame while the render task runs ahead of loop()
+static const size_t   SERIAL_RX_BUFFER_SIZE = NUM_LEDS * 3 + 64;
+
+// Return to the command line when no stream data arrives for this long
+static const uint32_t SERIAL_STREAM_TIMEOUT_MS = 1000;
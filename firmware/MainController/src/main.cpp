@@ -24,13 +24,18 @@
 #include "ProjectorController.h"
 #include "KeypadDriver.h"
 #include "MqttClient.h"
+#include "LoopProfiler.h"
+#include "AdalightInput.h"
 
 Settings settings;
 CommandLine cmdline;
 MqttClient mqttClient(settings);
-LEDDriver LEDs(settings, mqttClient);
+StripOutput stripOutput;
+LEDDriver LEDs(settings, mqttClient, stripOutput);
+AdalightInput adalight(LEDs);
 ProjectorController Projector(settings, mqttClient);
 KeypadDriver Keypad(settings, LEDs, Projector);
+LoopProfiler profiler(settings, mqttClient, LEDs);
 
 
 class StatusParser: public CommandParser
@@ -46,6 +51,12 @@ class StatusParser: public CommandParser
             Serial.printf("Light Intensity: %hhu\n", LEDs.intensity());
             Serial.printf("Dimmed Intensity: %hhu\n", LEDs.dimmedIntensity());
             Serial.printf("RGB Strip Mode: %s\n", strRGBMode(LEDs.rgbMode()));
+            Serial.printf("RGB Strip Frame Rate: %hu fps\n", LEDs.frameRate());
+            Serial.printf("RGB Strip Dithering: %s\n", strBool(LEDs.isDitherEnabled()));
+            Serial.printf("RGB Strip Transition: %u ms\n", LEDs.transition());
+            Serial.printf("Color Ramp: %hu ms\n", LEDs.rampTime());
+            Serial.printf("Realtime Input: %s, %u packets, %u invalid\n", LEDs.realtimeInput().isActive() ? "active" : "idle",
+                          LEDs.realtimeInput().packetCount(), LEDs.realtimeInput().invalidCount());
             Serial.printf("Projector Mode: %s\n", strProjectorCommand(Projector.mode()));
             Serial.printf("HSV: %hhu %hhu %hhu\n", LEDs.getHSV().hue, LEDs.getHSV().sat, LEDs.getHSV().val);
             Serial.printf("WiFi SSID: %s PW: %s\n", settings.getWiFiSSID(), settings.getWiFiPassword());
@@ -260,16 +271,31 @@ class LEDParser: public CommandParser {
         RGBMode mMode;
         bool    mLEDEnable;
         CHSV    mColor;
+        bool    mSetDither;
+        bool    mDither;
+        bool    mSetRamp;
+        int     mRampMillis;
+        bool    mNotify;
+        NotifyAnimation mAnimation;
+        int     mNotifyCount;
+        CRGB    mNotifyColor;
 
     public:
         LEDParser() {}
 
         virtual void printArguments() {
-            Serial.print("on|off|cycle|spin|scan|fire|water|rainbow|bpm|color <h> <s> <v>");
+            for (uint8_t i = 0; i < numEffects(); i++) {
+                Serial.print(effectAt(i).name);
+                Serial.print("|");
+            }
+            Serial.print("off|color <h> <s> <v>|dither <on|off>|ramp <ms>|notify <pulse|sweep|blink> [<count>] [#rrggbb]");
         }
 
         virtual CmdParseStatus startCommand(const char* cmd) {
             mCommand = CMD_READ_STATUS;
+            mSetDither = false;
+            mSetRamp = false;
+            mNotify = false;
 
             return CPSNextArgument;
         }
@@ -291,8 +317,41 @@ class LEDParser: public CommandParser {
                     mCommand = CMD_HSV_COLOR;
                     return CPSNextArgument;
                 }
+                if (strcmp(arg, "dither") == 0) {
+                    mSetDither = true;
+                    return CPSNextArgument;
+                }
+                if (strcmp(arg, "ramp") == 0) {
+                    mSetRamp = true;
+                    return CPSNextArgument;
+                }
+                if (strcmp(arg, "notify") == 0) {
+                    mNotify = true;
+                    mNotifyCount = 1;
+                    mNotifyColor = CRGB::White;
+                    return CPSNextArgument;
+                }
                 return CPSInvalidArgument;
             }
+            if (mNotify) {
+                if (argNo == 1) {
+                    return parseNotifyAnimation(arg, mAnimation) ? CPSComplete : CPSInvalidArgument;
+                }
+                // Optional count, then the optional color
+                if (argNo == 2 && parseInteger(arg, mNotifyCount, 1, LED_NOTIFY_MAX_BLINKS)) {
+                    return CPSComplete;
+                }
+                if (argNo <= 3 && parseHexColor(arg, mNotifyColor)) {
+                    return CPSComplete;
+                }
+                return CPSInvalidArgument;
+            }
+            if (mSetDither && argNo == 1) {
+                return parseBool(arg, mDither) ? CPSComplete : CPSInvalidArgument;
+            }
+            if (mSetRamp && argNo == 1) {
+                return parseInteger(arg, mRampMillis, 0, 10000) ? CPSComplete : CPSInvalidArgument;
+            }
             if (mCommand == CMD_HSV_COLOR) {
                 if (argNo > 0 and argNo < 4) {
                     int v;
@@ -312,6 +371,18 @@ class LEDParser: public CommandParser {
         }
 
         virtual CmdExecStatus completeCommand(bool expectCommand) {
+            if (mSetDither && !expectCommand) {
+                LEDs.enableDither(mDither);
+                return CmdExecStatus::CESOK;
+            }
+            if (mSetRamp && !expectCommand) {
+                LEDs.setRampTime(mRampMillis);
+                return CmdExecStatus::CESOK;
+            }
+            if (mNotify && !expectCommand) {
+                LEDs.notify(mAnimation, mNotifyColor, mNotifyCount);
+                return CmdExecStatus::CESOK;
+            }
             if (mCommand == CMD_RGB_MODE) {
                 LEDs.enableLEDStrip(mLEDEnable);
                 LEDs.enableLamps(mLEDEnable);
@@ -400,6 +471,65 @@ class ProjectorParser: public CommandParser {
         }
 };
 
+class PerfParser: public CommandParser {
+    private:
+        enum PerfCommand {
+            PC_SHOW,
+            PC_RESET,
+            PC_MQTT
+        };
+        PerfCommand mCmd;
+        int mInterval;
+
+    public:
+        PerfParser() {}
+
+        virtual void printArguments() {
+            Serial.print("[reset|mqtt <seconds>]");
+        }
+
+        virtual CmdParseStatus startCommand(const char* cmd) {
+            mCmd = PC_SHOW;
+            // Arguments are optional, but must be accepted
+            return CPSNextArgument;
+        }
+
+        virtual CmdParseStatus parseNextArgument(int argNo, const char* arg) {
+            if (argNo == 0) {
+                if (strcmp(arg, "reset") == 0) {
+                    mCmd = PC_RESET;
+                    return CPSComplete;
+                }
+                if (strcmp(arg, "mqtt") == 0) {
+                    mCmd = PC_MQTT;
+                    return CPSNextArgument;
+                }
+            }
+            if (mCmd == PC_MQTT && argNo == 1) {
+                if (parseInteger(arg, mInterval, 0, 3600)) {
+                    return CPSComplete;
+                }
+            }
+            return CPSInvalidArgument;
+        }
+
+        virtual CmdExecStatus completeCommand(bool expectCommand) {
+            if (mCmd == PC_SHOW) {
+                profiler.printStats();
+                return CmdExecStatus::CESOK;
+            }
+            if (mCmd == PC_RESET) {
+                profiler.reset();
+                return CmdExecStatus::CESOK;
+            }
+            if (mCmd == PC_MQTT && !expectCommand) {
+                profiler.setTelemetryInterval(mInterval);
+                return CmdExecStatus::CESOK;
+            }
+            return CmdExecStatus::CESInvalidArgument;
+        }
+};
+
 void onProjectorStatus(bool switchState, bool powerOn, bool hasPowerStatus, bool isPowering) {
 
     Serial.printf("[Projector] Status: Power %s%s, Switch %s\n", hasPowerStatus ? strBool(powerOn) : "-", 
@@ -443,7 +573,10 @@ void setup() {
     cmdline.addCommand("mqtt", new MQTTParser());
     cmdline.addCommand("screen", new ScreenParser());
     cmdline.addCommand("projector", new ProjectorParser());
+    cmdline.addCommand("perf", new PerfParser());
+    cmdline.setStreamParser(&adalight);
 
+    LEDs.setProfiler(&profiler);
     LEDs.begin();
 
     Projector.setStatusCallback(onProjectorStatus);
@@ -458,17 +591,38 @@ void setup() {
     WiFi.begin(settings.getWiFiSSID(), settings.getWiFiPassword());
 
     mqttClient.setup();
+
+    profiler.begin();
 }
 
 void loop() {
+    profiler.start(PROF_LOOP);
+
+    profiler.start(PROF_KEYPAD);
     Keypad.loop();
+    profiler.stop(PROF_KEYPAD);
+
+    profiler.start(PROF_CMDLINE);
     cmdline.loop();
+    profiler.stop(PROF_CMDLINE);
+
+    profiler.start(PROF_MQTT);
     mqttClient.loop();
+    profiler.stop(PROF_MQTT);
+
+    // Frames are rendered and profiled in the render task
     LEDs.loop();
+
+    profiler.start(PROF_PROJECTOR);
     Projector.loop();
+    profiler.stop(PROF_PROJECTOR);
+
+    profiler.loop();
 
     EVERY_N_SECONDS( 20 ) {
         checkWiFiConnection();
         checkMQTTConnection();
     }
+
+    profiler.stop(PROF_LOOP);
 }
@@ -34,6 +34,12 @@ static const int UART_SPEED_CONTROLLER = 9600; // 38400;
 
 static const int UART_SPEED_PROJECTOR = 9600;
 
+// Slowest tempo of the beat driven effects, in beats per minute
+static const uint8_t TEMPO_MIN_BPM = 5;
+
+// Taps further apart than a beat at the slowest tempo, plus some slack, end the tempo measurement
+static const unsigned long TAP_TIMEOUT_MS = 60000UL / TEMPO_MIN_BPM + 1000;
+
 /**
  * UART command codes
  **/
@@ -68,6 +74,9 @@ enum CommandOpcode : uint8_t {
     // Projector lift command. Value = LiftCommand.
     CMD_PROJECTOR_LIFT    = 0x09,
 
+    // Tap tempo, the beat falls on the tap. Value = 0
+    CMD_TAP_TEMPO         = 0x0A,
+
     // Request status. Value = 0
     CMD_REQUEST_STATUS    = 0x10,
 
@@ -111,7 +120,29 @@ enum RGBMode : uint8_t {
     // RGB rainbow
     RGB_RAINBOW = 0x08,
     // RGB water 
-    RGB_WATER   = 0x09
+    RGB_WATER   = 0x09,
+    // RGB waves from the room center
+    RGB_RIPPLE  = 0x0A,
+    // RGB band sweeping across the room
+    RGB_SWEEP   = 0x0B,
+    // RGB meteors crossing the strip
+    RGB_METEOR  = 0x0C,
+    // RGB bursts of sparks
+    RGB_SPARKS  = 0x0D,
+    // RGB balls bouncing up from the strip ends
+    RGB_BALLS   = 0x0E,
+    // RGB slowly flowing lava
+    RGB_LAVA    = 0x0F,
+    // RGB northern lights curtains
+    RGB_AURORA  = 0x10,
+    // RGB drifting clouds
+    RGB_CLOUDS  = 0x11,
+    // RGB VU meter of the audio volume
+    RGB_VU      = 0x12,
+    // RGB pulse with the audio bass
+    RGB_BASS    = 0x13,
+    // RGB audio spectrum along the strip
+    RGB_SPECTRUM = 0x14
 };
 
 enum LiftCommand : uint8_t {